@@ -690,11 +690,11 @@ int yy_flex_debug = 1;
 
 static const flex_int16_t yy_rule_linenum[48] =
     {   0,
-       81,   82,   83,   84,   85,   86,   87,   88,   89,   90,
-       91,   92,   93,   94,   95,   96,   97,  103,  112,  121,
-      130,  134,  142,  150,  161,  166,  177,  184,  195,  201,
-      205,  209,  213,  217,  221,  225,  236,  242,  247,  252,
-      256,  263,  267,  279,  288,  297,  299
+      147,  148,  149,  150,  151,  152,  153,  154,  155,  156,
+      157,  158,  159,  160,  161,  162,  163,  169,  178,  187,
+      196,  200,  208,  216,  227,  232,  245,  251,  261,  267,
+      271,  275,  279,  283,  287,  291,  304,  312,  318,  323,
+      327,  334,  336,  349,  358,  367,  371
     } ;
 
 /* The intent behind this definition is that it'll catch
@@ -718,9 +718,9 @@ char *yytext;
 #include <cool-parse.h>
 #include <stringtab.h>
 #include <utilities.h>
+#include <scan-input.h>
 
 /* The compiler assumes these identifiers. */
-#define yylval cool_yylval
 #define yylex  cool_yylex
 
 /* Max size of string constants */
@@ -738,13 +738,51 @@ extern FILE *fin; /* we read from this file */
 	if ( (result = fread( (char*)buf, sizeof(char), max_size, fin)) < 0) \
 		YY_FATAL_ERROR( "read() in flex scanner failed");
 
-char string_buf[MAX_STR_CONST]; /* to assemble string constants */
-char *string_buf_ptr;
+/*
+ *  TYPEID, OBJECTID, INT_CONST and STR_CONST tokens are handed to the
+ *  parser as spans of the input (lval->span), which stays in
+ *  memory, unmoved, until cool_scan_end (see below); the parser interns
+ *  their text only when it builds a node.  A string constant without
+ *  escapes is a slice of the input.  One with escapes is decoded in
+ *  place, over the characters already scanned, since the decoded text
+ *  is never longer than the source.
+ */
+#define SET_SPAN(s, n)	(lval->span.text = (s), lval->span.len = (n))
+
+char *string_start;	/* the text of the string constant being scanned */
+char *string_end;	/* the end of its text so far */
 
-extern int curr_lineno;
 extern int verbose_flag;
 
-extern YYSTYPE cool_yylval;
+/*
+ *  The scanner flex makes from the rules is scan_token.  It sets the
+ *  value of each token through lval rather than in the parser's
+ *  cool_yylval, and does not count lines: cool_scan_token (at the end of
+ *  this file) finds the line of a token from where it ends, with the
+ *  line index of the input (see scan-input.cc).  So the scanner can run
+ *  on a thread of its own, ahead of the parser (see coolc.cc).
+ */
+#define YY_DECL static int scan_token(YYSTYPE *lval)
+
+/*
+ *  The message for a character that starts no token is that character,
+ *  kept here rather than in yytext, which the next token overwrites.
+ */
+static char stray[256][2];
+
+static struct StrayMessages {
+	StrayMessages()
+	{
+		for (int c = 0; c < 256; c++)
+			stray[c][0] = c;
+	}
+} stray_messages;
+
+/*
+ *  The state of the scanner is in the static variables of the code that
+ *  flex makes, so only one thread at a time may scan (see coolc -j).
+ */
+int cool_scan_threadsafe = 0;
 
 /*
  *  Add Your own definitions here
@@ -752,12 +790,40 @@ extern YYSTYPE cool_yylval;
 
 int commentLayer; /* For counting layers of nested comment */
 
-#line 756 "cool-lex.cc"
+/*
+ *  Runs of whitespace and comments are skipped by skip_trivia (see
+ *  scan-input.cc), 16 bytes at a time where it can, rather than by
+ *  the rules, which take a DFA step per byte and an action per
+ *  newline.  The rules that begin whitespace or a comment call
+ *  SKIP_TRIVIA, which moves the scanner past the rest of the run, if
+ *  there is any: most often a blank is followed by a token, and that is
+ *  cheaper to see here.  It stops at the end of the current buffer; the
+ *  rules scan what is left.  SKIP_TRIVIA works on the buffer variables
+ *  of the scanner flex 2.6 makes (yy_c_buf_p, yy_hold_char, yy_n_chars),
+ *  which are not an interface of flex, so other versions are refused.
+ */
+#if YY_FLEX_MAJOR_VERSION != 2 || YY_FLEX_MINOR_VERSION != 6
+#error "SKIP_TRIVIA needs the scanner of flex 2.6"
+#endif
+#define SCAN_END	(YY_CURRENT_BUFFER_LVALUE->yy_ch_buf + yy_n_chars)
+#define TRIVIA_AHEAD(c, d) \
+	(IS_BLANK(c) || ((c) == '-' && (d) == '-') || ((c) == '(' && (d) == '*'))
+#define SKIP_TRIVIA() do { \
+	if (commentLayer > 0 || TRIVIA_AHEAD(yy_hold_char, yy_c_buf_p[1])) { \
+		*yy_c_buf_p = yy_hold_char; \
+		yy_c_buf_p = skip_trivia(yy_c_buf_p, SCAN_END, &commentLayer, \
+					 yyout); \
+		yy_hold_char = *yy_c_buf_p; \
+		BEGIN(commentLayer > 0 ? NCOMMENT : INITIAL); \
+	} \
+} while (0)
+
+#line 822 "cool-lex.cc"
 /*
  * Define names for regular expressions here.
  */
 
-#line 761 "cool-lex.cc"
+#line 827 "cool-lex.cc"
 
 #define INITIAL 0
 #define NCOMMENT 1
@@ -1039,16 +1105,16 @@ YY_DECL
 
 	{
 /* %% [7.0] user's declarations go here */
-#line 73 "cool.flex"
+#line 139 "cool.flex"
 
 
-#line 76 "cool.flex"
+#line 142 "cool.flex"
  /*
   * Keywords are case-insensitive except for the values true and false,
   * which must begin with a lower-case letter.
   */
 
-#line 1052 "cool-lex.cc"
+#line 1118 "cool-lex.cc"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -1130,87 +1196,87 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 81 "cool.flex"
+#line 147 "cool.flex"
 {return CLASS;}
 	YY_BREAK
 case 2:
 YY_RULE_SETUP
-#line 82 "cool.flex"
+#line 148 "cool.flex"
 {return ELSE;}
 	YY_BREAK
 case 3:
 YY_RULE_SETUP
-#line 83 "cool.flex"
+#line 149 "cool.flex"
 {return FI;}
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 84 "cool.flex"
+#line 150 "cool.flex"
 {return IF;}
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 85 "cool.flex"
+#line 151 "cool.flex"
 {return IN;}
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 86 "cool.flex"
+#line 152 "cool.flex"
 {return ISVOID;}
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 87 "cool.flex"
+#line 153 "cool.flex"
 {return INHERITS;}
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 88 "cool.flex"
+#line 154 "cool.flex"
 {return LET;}
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 89 "cool.flex"
+#line 155 "cool.flex"
 {return LOOP;}
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 90 "cool.flex"
+#line 156 "cool.flex"
 {return POOL;}
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 91 "cool.flex"
+#line 157 "cool.flex"
 {return THEN;}
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 92 "cool.flex"
+#line 158 "cool.flex"
 {return WHILE;}
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 93 "cool.flex"
+#line 159 "cool.flex"
 {return CASE;}
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 94 "cool.flex"
+#line 160 "cool.flex"
 {return ESAC;}
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 95 "cool.flex"
+#line 161 "cool.flex"
 {return NEW;}
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 96 "cool.flex"
+#line 162 "cool.flex"
 {return OF;}
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 97 "cool.flex"
+#line 163 "cool.flex"
 {return NOT;}
 	YY_BREAK
 /*
@@ -1218,9 +1284,9 @@ YY_RULE_SETUP
   */
 case 18:
 YY_RULE_SETUP
-#line 103 "cool.flex"
+#line 169 "cool.flex"
 {
-   	cool_yylval.symbol = inttable.add_string(yytext);
+   	SET_SPAN(yytext, yyleng);
     	return (INT_CONST);
 }
 	YY_BREAK
@@ -1229,9 +1295,9 @@ YY_RULE_SETUP
   */
 case 19:
 YY_RULE_SETUP
-#line 112 "cool.flex"
+#line 178 "cool.flex"
 {
-    	cool_yylval.symbol = idtable.add_string(yytext);
+    	SET_SPAN(yytext, yyleng);
     	return (TYPEID);
 }
 	YY_BREAK
@@ -1240,9 +1306,9 @@ YY_RULE_SETUP
   */
 case 20:
 YY_RULE_SETUP
-#line 121 "cool.flex"
+#line 187 "cool.flex"
 {
-	cool_yylval.symbol = idtable.add_string(yytext);
+	SET_SPAN(yytext, yyleng);
 	return (OBJECTID);
 }
 	YY_BREAK
@@ -1251,14 +1317,14 @@ YY_RULE_SETUP
   */
 case 21:
 YY_RULE_SETUP
-#line 130 "cool.flex"
+#line 196 "cool.flex"
 {
 	return (DARROW);
 }
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 134 "cool.flex"
+#line 200 "cool.flex"
 {
   	return (ASSIGN);
 }
@@ -1268,7 +1334,7 @@ YY_RULE_SETUP
   */
 case 23:
 YY_RULE_SETUP
-#line 142 "cool.flex"
+#line 208 "cool.flex"
 {
 	return (yytext[0]);
 }
@@ -1279,9 +1345,9 @@ YY_RULE_SETUP
 case 24:
 /* rule 24 can match eol */
 YY_RULE_SETUP
-#line 150 "cool.flex"
+#line 216 "cool.flex"
 {
-	curr_lineno++;
+	SKIP_TRIVIA();
 }
 	YY_BREAK
 /*
@@ -1292,113 +1358,115 @@ YY_RULE_SETUP
   */
 case 25:
 YY_RULE_SETUP
-#line 161 "cool.flex"
+#line 227 "cool.flex"
 {
 	BEGIN(STRING);
-	string_buf_ptr = string_buf;
+	string_start = string_end = yytext + 1;
 }
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
-#line 166 "cool.flex"
+#line 232 "cool.flex"
 {
 	BEGIN(INITIAL);
-	*string_buf_ptr = '\0';
-  	if(string_buf_ptr >= &string_buf[MAX_STR_CONST - 1]) {
-		cool_yylval.error_msg = "String constant too long.";
+	int len = string_end - string_start;
+  	if(len >= MAX_STR_CONST - 1) {
+		lval->error_msg = "String constant too long.";
 		return(ERROR);
 	}
-	cool_yylval.symbol = stringtable.add_string(string_buf);
+	/* like a C string, the constant ends at an escaped null character */
+	char *nul = (char *) memchr(string_start, '\0', len);
+	SET_SPAN(string_start, nul ? nul - string_start : len);
     	return (STR_CONST);
 }
 	YY_BREAK
 case 27:
 /* rule 27 can match eol */
 YY_RULE_SETUP
-#line 177 "cool.flex"
+#line 245 "cool.flex"
 {
-  	curr_lineno++;
 	BEGIN(INITIAL);
-	cool_yylval.error_msg = "Unterminated string constant.";
+	lval->error_msg = "Unterminated string constant.";
 	return (ERROR);
 }
 	YY_BREAK
 case 28:
 /* rule 28 can match eol */
 YY_RULE_SETUP
-#line 184 "cool.flex"
+#line 251 "cool.flex"
 {
-	curr_lineno++;
-	*string_buf_ptr++ = yytext[1];
+	*string_end++ = yytext[1];
 }
 	YY_BREAK
 case YY_STATE_EOF(STRING):
-#line 189 "cool.flex"
+#line 255 "cool.flex"
 {
-	cool_yylval.error_msg = "EOF in string constant.";
+	lval->error_msg = "EOF in string constant.";
 	BEGIN(INITIAL);
 	return (ERROR); 
 }
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
-#line 195 "cool.flex"
+#line 261 "cool.flex"
 {
-	cool_yylval.error_msg = "Null character in string.";
+	lval->error_msg = "Null character in string.";
 	BEGIN(INITIAL);
 	return (ERROR);
 }
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
-#line 201 "cool.flex"
+#line 267 "cool.flex"
 {
-  	*string_buf_ptr++ = '\n';
+  	*string_end++ = '\n';
 }
 	YY_BREAK
 case 31:
 YY_RULE_SETUP
-#line 205 "cool.flex"
+#line 271 "cool.flex"
 {
-	*string_buf_ptr++ = '\t';
+	*string_end++ = '\t';
 }
 	YY_BREAK
 case 32:
 YY_RULE_SETUP
-#line 209 "cool.flex"
+#line 275 "cool.flex"
 {
-	*string_buf_ptr++ = '\r';
+	*string_end++ = '\r';
 }
 	YY_BREAK
 case 33:
 YY_RULE_SETUP
-#line 213 "cool.flex"
+#line 279 "cool.flex"
 {
-	*string_buf_ptr++ = '\b';
+	*string_end++ = '\b';
 }
 	YY_BREAK
 case 34:
 YY_RULE_SETUP
-#line 217 "cool.flex"
+#line 283 "cool.flex"
 {
-	*string_buf_ptr++ = '\f';
+	*string_end++ = '\f';
 }
 	YY_BREAK
 case 35:
 YY_RULE_SETUP
-#line 221 "cool.flex"
+#line 287 "cool.flex"
 {
-  	*string_buf_ptr++ = yytext[1];
+  	*string_end++ = yytext[1];
 }
 	YY_BREAK
 case 36:
 YY_RULE_SETUP
-#line 225 "cool.flex"
+#line 291 "cool.flex"
 {
-	char *yptr = yytext;
-	while (*yptr) {
-		 *string_buf_ptr++ = *yptr++;
-	}
+	/* text after a null character in the run is dropped with it */
+	char *nul = (char *) memchr(yytext, '\0', yyleng);
+	int n = nul ? nul - yytext : yyleng;
+	if (string_end != yytext)
+		memmove(string_end, yytext, n);
+	string_end += n;
 }
 	YY_BREAK
 /*
@@ -1406,38 +1474,41 @@ YY_RULE_SETUP
   */
 case 37:
 YY_RULE_SETUP
-#line 236 "cool.flex"
-;
+#line 304 "cool.flex"
+{
+	SKIP_TRIVIA();
+}
 	YY_BREAK
 /*
   * Nested comments
   */
 case 38:
 YY_RULE_SETUP
-#line 242 "cool.flex"
+#line 312 "cool.flex"
 {
 	commentLayer = 1;
 	BEGIN (NCOMMENT);
+	SKIP_TRIVIA();
 }
 	YY_BREAK
 case 39:
 YY_RULE_SETUP
-#line 247 "cool.flex"
+#line 318 "cool.flex"
 {
-	cool_yylval.error_msg = "Unmatched *)";
+	lval->error_msg = "Unmatched *)";
 	return (ERROR);
 }
 	YY_BREAK
 case 40:
 YY_RULE_SETUP
-#line 252 "cool.flex"
+#line 323 "cool.flex"
 {
   	commentLayer++;
 }
 	YY_BREAK
 case 41:
 YY_RULE_SETUP
-#line 256 "cool.flex"
+#line 327 "cool.flex"
 {
   	if(commentLayer == 1) {
     		BEGIN(INITIAL);
@@ -1448,21 +1519,20 @@ YY_RULE_SETUP
 case 42:
 /* rule 42 can match eol */
 YY_RULE_SETUP
-#line 263 "cool.flex"
-{
-	curr_lineno++;
-}
+#line 334 "cool.flex"
+;
 	YY_BREAK
 case 43:
 YY_RULE_SETUP
-#line 267 "cool.flex"
+#line 336 "cool.flex"
 ;
 	YY_BREAK
 case YY_STATE_EOF(NCOMMENT):
-#line 269 "cool.flex"
+#line 338 "cool.flex"
 {
 	BEGIN (INITIAL);
-	cool_yylval.error_msg = "EOF in comment.";
+	commentLayer = 0;
+	lval->error_msg = "EOF in comment.";
 	return (ERROR); 
 }
 	YY_BREAK
@@ -1471,9 +1541,9 @@ case YY_STATE_EOF(NCOMMENT):
   */
 case 44:
 YY_RULE_SETUP
-#line 279 "cool.flex"
+#line 349 "cool.flex"
 {
-	cool_yylval.boolean = 1;
+	lval->boolean = 1;
 	return (BOOL_CONST);
 }
 	YY_BREAK
@@ -1482,9 +1552,9 @@ YY_RULE_SETUP
   */
 case 45:
 YY_RULE_SETUP
-#line 288 "cool.flex"
+#line 358 "cool.flex"
 {
-	cool_yylval.boolean = 0;
+	lval->boolean = 0;
 	return (BOOL_CONST);
 }
 	YY_BREAK
@@ -1493,23 +1563,25 @@ YY_RULE_SETUP
   */
 case 46:
 YY_RULE_SETUP
-#line 297 "cool.flex"
-;
+#line 367 "cool.flex"
+{
+	SKIP_TRIVIA();
+}
 	YY_BREAK
 case 47:
 YY_RULE_SETUP
-#line 299 "cool.flex"
+#line 371 "cool.flex"
 {
-	cool_yylval.error_msg = yytext;
+	lval->error_msg = stray[(unsigned char) yytext[0]];
 	return (ERROR);
 }
 	YY_BREAK
 case 48:
 YY_RULE_SETUP
-#line 304 "cool.flex"
+#line 376 "cool.flex"
 ECHO;
 	YY_BREAK
-#line 1513 "cool-lex.cc"
+#line 1585 "cool-lex.cc"
 case YY_STATE_EOF(INITIAL):
 	yyterminate();
 
@@ -2658,6 +2730,48 @@ void yyfree (void * ptr )
 
 /* %ok-for-header */
 
-#line 304 "cool.flex"
+#line 376 "cool.flex"
 
 
+/*
+ *  cool_scan_file(name) makes the file `name' the input of the scanner.
+ *  The file is mapped into memory, or read whole, by scan_input_open
+ *  (see scan-input.cc), and scanned in place through yy_scan_buffer, so
+ *  that the tokens' spans stay valid until cool_scan_end releases the
+ *  input, once the parser (or whatever else took the tokens) is done
+ *  with it.  cool_scan_file returns 0 if the file cannot be opened.
+ */
+
+static ScanInput scan_input;
+
+int cool_scan_file(char *name)
+{
+	if (!scan_input_open(name, &scan_input))
+		return 0;
+	fin = NULL;
+	yy_scan_buffer(scan_input.text, scan_input.len + 2);
+	BEGIN(INITIAL);
+	return 1;
+}
+
+void cool_scan_end()
+{
+	if (scan_input.text) {
+		yy_delete_buffer(YY_CURRENT_BUFFER);
+		scan_input_close(&scan_input);
+	}
+}
+
+/*
+ *  cool_scan_token(lval, lineno) scans the next token, and returns it
+ *  with its value in *lval and its line in *lineno; 0 is the end of the
+ *  input.  lextest.cc calls it, and so does the parser's cool_yylex in
+ *  coolc.cc, directly or from another thread.
+ */
+int cool_scan_token(YYSTYPE *lval, int *lineno)
+{
+	int token = scan_token(lval);
+	*lineno = scan_input_line(&scan_input, yy_c_buf_p);
+	return token;
+}
+
@@ -0,0 +1,742 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  cool-scan.cc
+//
+//  A direct-coded scanner for COOL, to be linked in place of cool-lex.cc
+//  (make SCANNER=direct).  It takes the same input, through
+//  cool_scan_file and cool_scan_end, and returns the same tokens as the
+//  scanner of cool.flex, quirks included: it is meant to be told apart
+//  from that one only by its speed.
+//
+//  The tables of the flex scanner spell out each case-insensitive
+//  keyword as its own path through the DFA.  Here the code that scans
+//  a token is chosen by its first character, and an identifier is
+//  scanned once and then looked up in a perfect hash table of the
+//  keywords, with its letters folded to lower case.
+//
+//  The rules of cool.flex are not those of the COOL manual, and where
+//  they differ this scanner follows cool.flex, which takes the longest
+//  match, and of matches of the same length the one of the earliest rule:
+//
+//      TYPEID is [A-Z][a-zA-Z_]* and OBJECTID is [a-z][a-z_]*, so
+//      there are no digits in identifiers ("x1" is x and 1), and an
+//      object identifier ends at an upper-case letter;
+//
+//      a keyword may be a prefix of a word of letters ("iFoo" is IF and
+//      oo), when it is longer than the object identifier there;
+//
+//      true and false are t(?i:rue) and f(?i:alse), but "true" is an
+//      object identifier, which comes first;
+//
+//      "<=", "~", "!" and "#" are not tokens, and the error for a stray
+//      character is that character (a null gives an empty message).
+//
+//  Whitespace, comments, and the errors for them, are left to
+//  skip_trivia (see scan-input.cc), which also serves cool.flex.
+//
+//  With -C n, a large file is scanned in pieces, on as many as n threads
+//  at once (see "Scanning in pieces" below).
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "cool-parse.h"
+#include "stringtab.h"
+#include "scan-input.h"
+
+/* Max size of string constants */
+#define MAX_STR_CONST 1025
+
+int yy_flex_debug;	/* set by -l; there are no rules to trace here */
+FILE *yyout = stdout;	/* where unmatched text is echoed, as by flex */
+
+/*
+ *  The input and the place in it are kept one per thread, so that several
+ *  threads can scan files at once (coolc -j).
+ */
+int cool_scan_threadsafe = 1;
+
+static __thread ScanInput scan_input;
+static __thread char *pos;	/* where the next token starts */
+static __thread char *end;	/* the end of the input, or of the piece */
+static __thread char *input_end;	/* the end of the input */
+
+/*
+ *  While a piece is scanned, the scan's state where it stops short of
+ *  input_end: 0 between tokens, n > 0 in a comment n deep, or
+ *  STOP_STRING in a string constant (and pos is then at its quote).
+ *  String constants are decoded into scratch and kept in piece_strings,
+ *  and what is echoed goes to echo_to.  See "Scanning in pieces".
+ */
+#define STOP_STRING	-1
+
+static __thread int scan_stop;
+static __thread Arena *piece_strings;
+static __thread FILE *echo_to;
+static __thread char *scratch;
+static __thread size_t scratch_size;
+
+#define ECHO_FILE	(echo_to ? echo_to : yyout)
+
+#define SET_SPAN(s, n)	(lval->span.text = (s), lval->span.len = (n))
+
+#define IS_DIGIT(c)	((c) >= '0' && (c) <= '9')
+#define IS_LOWER(c)	(((c) >= 'a' && (c) <= 'z') || (c) == '_')
+#define IS_LETTER(c)	(IS_LOWER(c) || ((c) >= 'A' && (c) <= 'Z'))
+#define FOLD(c)		((c) | 0x20)	/* lower case, for a letter */
+
+/*
+ *  The keywords, by hash.  keyword_hash gives each of them a slot of its
+ *  own, from its length and its first two letters folded to lower case.
+ *  Being a keyword is not a matter of case, so a word hashes the same
+ *  in any case; it is a keyword if its slot holds it, compared folded.
+ */
+
+#define KEYWORD_SLOTS	32
+#define keyword_hash(s, len) \
+	((7 * (len) + 5 * FOLD(s[0]) + 7 * FOLD(s[1])) & (KEYWORD_SLOTS - 1))
+
+static struct {
+	const char *text;
+	int token;
+} keywords[KEYWORD_SLOTS] = {
+	{ NULL, 0 },         { "loop", LOOP },   { NULL, 0 },       { "of", OF },
+	{ "not", NOT },      { "if", IF },       { "class", CLASS }, { "inherits", INHERITS },
+	{ NULL, 0 },         { "else", ELSE },   { NULL, 0 },       { "fi", FI },
+	{ NULL, 0 },         { NULL, 0 },        { "while", WHILE }, { NULL, 0 },
+	{ NULL, 0 },         { NULL, 0 },        { "case", CASE },  { NULL, 0 },
+	{ "let", LET },      { "pool", POOL },   { NULL, 0 },       { NULL, 0 },
+	{ "then", THEN },    { NULL, 0 },        { "esac", ESAC },  { NULL, 0 },
+	{ "isvoid", ISVOID }, { "in", IN },      { "new", NEW },    { NULL, 0 },
+};
+
+/* the token of the keyword that is the len letters at s, or 0 */
+static int keyword(char *s, int len)
+{
+	if (len < 2 || len > 8)
+		return 0;
+	int slot = keyword_hash(s, len);
+	const char *k = keywords[slot].text;
+	if (k == NULL)
+		return 0;
+	for (int i = 0; i < len; i++)	/* stops at the end of k */
+		if (FOLD(s[i]) != k[i])
+			return 0;
+	return k[len] == '\0' ? keywords[slot].token : 0;
+}
+
+/* the length of t(?i:rue) or f(?i:alse) at the len letters at s, or 0 */
+static int bool_length(char *s, int len)
+{
+	if (s[0] == 't' && len >= 4 && FOLD(s[1]) == 'r' &&
+	    FOLD(s[2]) == 'u' && FOLD(s[3]) == 'e')
+		return 4;
+	if (s[0] == 'f' && len >= 5 && FOLD(s[1]) == 'a' &&
+	    FOLD(s[2]) == 'l' && FOLD(s[3]) == 's' && FOLD(s[4]) == 'e')
+		return 5;
+	return 0;
+}
+
+/*
+ *  A word that starts with a letter.  The input ends in null bytes, so
+ *  scanning a word stops there if not before.
+ */
+static int word(char *s, YYSTYPE *lval)
+{
+	char *p = s + 1;
+	int token;
+
+	if (!IS_LOWER(s[0])) {			/* a type identifier */
+		while (IS_LETTER(*p))
+			p++;
+		pos = p;
+		if ((token = keyword(s, p - s)))
+			return token;
+		SET_SPAN(s, p - s);
+		return TYPEID;
+	}
+
+	while (IS_LOWER(*p))
+		p++;
+	int object = p - s;
+	if (!IS_LETTER(*p)) {			/* all of the word */
+		pos = p;
+		if ((token = keyword(s, object)))
+			return token;
+		SET_SPAN(s, object);
+		return OBJECTID;
+	}
+
+	/*
+	 * The object identifier stops short of the word, at an upper-case
+	 * letter.  The longest match may be a keyword or a boolean that
+	 * goes on past it.
+	 */
+	while (IS_LETTER(*p))
+		p++;
+	int len = p - s, n;
+	for (n = len < 8 ? len : 8; n >= object; n--)
+		if ((token = keyword(s, n)))
+			break;
+	if (n < object) {
+		n = object;
+		token = OBJECTID;
+	}
+	int b = bool_length(s, len);
+	if (b > n) {
+		pos = s + b;
+		lval->boolean = s[0] == 't';
+		return BOOL_CONST;
+	}
+	pos = s + n;
+	if (token == OBJECTID)
+		SET_SPAN(s, n);
+	return token;
+}
+
+/*
+ *  A string constant, whose text starts at s.  Escapes are decoded in
+ *  place, as in cool.flex, and the constant ends up a span of the input;
+ *  in a piece, they are decoded into scratch, which is at least as long
+ *  as the rest of the piece, and the constant is copied to piece_strings.
+ */
+static int string_constant(char *s, YYSTYPE *lval)
+{
+	char *p = s, *out = s, *q;
+
+	if (piece_strings) {
+		if (scratch_size < (size_t) (end - s)) {
+			delete [] scratch;
+			scratch_size = end - s;
+			scratch = new char[scratch_size];
+		}
+		out = scratch;
+	}
+	char *text = out;
+
+	for (;;) {
+		if (p == end) {
+			if (end != input_end) {	/* it goes on in the next piece */
+				pos = s - 1;
+				scan_stop = STOP_STRING;
+				return 0;
+			}
+			pos = end;
+			lval->error_msg = "EOF in string constant.";
+			return ERROR;
+		}
+		switch (*p) {
+		case '"': {
+			pos = p + 1;
+			int len = out - text;
+			if (len >= MAX_STR_CONST - 1) {
+				lval->error_msg = "String constant too long.";
+				return ERROR;
+			}
+			/* like a C string, the constant ends at a null character */
+			char *nul = (char *) memchr(text, '\0', len);
+			SET_SPAN(text, nul ? nul - text : len);
+			if (piece_strings)
+				lval->span.text = piece_strings->copy_string(text,
+							lval->span.len);
+			return STR_CONST;
+		}
+		case '\n':
+			pos = p + 1;
+			lval->error_msg = "Unterminated string constant.";
+			return ERROR;
+		case '\\':
+			if (p + 1 == end) {		/* no rule matches: echoed */
+				putc('\\', ECHO_FILE);
+				p++;
+				break;
+			}
+			switch (p[1]) {
+			case 'n':  *out++ = '\n'; break;
+			case 't':  *out++ = '\t'; break;
+			case 'r':  *out++ = '\r'; break;
+			case 'b':  *out++ = '\b'; break;
+			case 'f':  *out++ = '\f'; break;
+			default:   *out++ = p[1]; break;
+			}
+			p += 2;
+			break;
+		default:
+			for (q = p + 1; q < end && *q != '"' && *q != '\n' && *q != '\\'; q++)
+				;
+			/*
+			 *  a null by itself is an error; in a longer run, it and
+			 *  the rest of the run are dropped, as in cool.flex
+			 */
+			if (q == p + 1 && *p == '\0') {
+				pos = q;
+				lval->error_msg = "Null character in string.";
+				return ERROR;
+			}
+			char *nul = (char *) memchr(p, '\0', q - p);
+			if (out != p)
+				memmove(out, p, (nul ? nul : q) - p);
+			out += (nul ? nul : q) - p;
+			p = q;
+			break;
+		}
+	}
+}
+
+/* the message for a character that starts no token: the character itself */
+static char stray[256][2];
+
+static struct StrayMessages {
+	StrayMessages()
+	{
+		for (int c = 0; c < 256; c++)
+			stray[c][0] = c;
+	}
+} stray_messages;
+
+/*
+ *  The value of the token goes in *lval rather than in the parser's
+ *  cool_yylval, so that the scanner can run on a thread of its own,
+ *  ahead of the parser (see coolc.cc).
+ */
+static int scan_token(YYSTYPE *lval)
+{
+	int layer;
+
+	for (;;) {
+		char *s = pos;
+		if (s == end) {
+			scan_stop = 0;
+			return 0;
+		}
+		switch (*s) {
+		case ' ': case '\t': case '\n': case '\v': case '\f': case '\r':
+		trivia:
+			layer = 0;
+			pos = skip_trivia(s, end, &layer, ECHO_FILE);
+			if (layer > 0) {
+				if (end != input_end) {	/* it goes on in the next piece */
+					scan_stop = layer;
+					return 0;
+				}
+				lval->error_msg = "EOF in comment.";
+				return ERROR;
+			}
+			continue;
+		case '-':
+			if (s[1] == '-')
+				goto trivia;
+			pos = s + 1;
+			return '-';
+		case '(':
+			if (s[1] == '*')
+				goto trivia;
+			pos = s + 1;
+			return '(';
+		case '*':
+			if (s[1] == ')') {
+				pos = s + 2;
+				lval->error_msg = "Unmatched *)";
+				return ERROR;
+			}
+			pos = s + 1;
+			return '*';
+		case '=':
+			if (s[1] == '>') {
+				pos = s + 2;
+				return DARROW;
+			}
+			pos = s + 1;
+			return '=';
+		case '<':
+			if (s[1] == '-') {
+				pos = s + 2;
+				return ASSIGN;
+			}
+			pos = s + 1;
+			return '<';
+		case '+': case '/': case '@': case '{': case '}': case ')':
+		case ',': case '.': case ':': case ';':
+			pos = s + 1;
+			return *s;
+		case '"':
+			return string_constant(s + 1, lval);
+		case '0': case '1': case '2': case '3': case '4':
+		case '5': case '6': case '7': case '8': case '9': {
+			char *p = s + 1;
+			while (IS_DIGIT(*p))
+				p++;
+			pos = p;
+			SET_SPAN(s, p - s);
+			return INT_CONST;
+		}
+		default:
+			if (IS_LETTER(*s) && *s != '_')
+				return word(s, lval);
+			pos = s + 1;
+			lval->error_msg = stray[(unsigned char) *s];
+			return ERROR;
+		}
+	}
+}
+
+/*
+ *  Scanning in pieces.
+ *
+ *  With -C n (scan_threads), a file of at least two PIECE_MIN bytes is
+ *  cut, at line ends, into as many as n pieces when it is opened.  The
+ *  pieces are scanned at once, each on a thread of its own, and the
+ *  tokens are then handed out in order by cool_scan_token.
+ *
+ *  Where the scan of a piece must start depends on the pieces before it:
+ *  a comment, some levels deep, or a string constant continued with a
+ *  backslash before the newline, may run on into it.  So each piece but
+ *  the first is scanned as though it started between tokens (its first
+ *  scan), and also as though it started in a comment 1, 2, ... up to
+ *  SPEC_DEPTH deep.  A scan from a comment stops as soon as it ends a
+ *  token where the first scan ended one, since from there on the two
+ *  are the same, and it goes on as the first scan.  Comments are seldom
+ *  long, so these scans are short.
+ *
+ *  The pieces are then stitched together in order: the state that the
+ *  scan chosen for one piece ends in chooses the scan of the next.  A
+ *  piece that starts in a string, or in a comment deeper than SPEC_DEPTH,
+ *  is scanned again then, from the string's quote (in an earlier piece)
+ *  or from its start, until it meets its first scan as above.  Strings
+ *  are not scanned for in advance: a newline ends one unless escaped,
+ *  which is rare, and scanning one again from its quote costs little.
+ *
+ *  A scan must not write into the text, which the other scans read, so
+ *  in a piece string constants are decoded into storage of the scan
+ *  rather than in place; and what the rules echo is kept with the
+ *  tokens, and written to yyout as they are handed out.
+ */
+extern int scan_threads;
+
+#define PIECE_MIN	(1 << 20)	/* the smallest piece worth a thread */
+#define SPEC_DEPTH	3		/* the comment depths a piece is scanned for */
+#define ECHOED		-1		/* a ScannedToken of echoed text */
+
+/*
+ *  A token is kept with where it ends, as an offset into the text, from
+ *  which its line is found as it is handed out.  What the scan echoed
+ *  before it, if anything, comes first, as an ECHOED token whose span is
+ *  the text, and whose end is that of the token before.
+ */
+struct ScannedToken {
+	int token;
+	unsigned after;
+	YYSTYPE lval;
+};
+
+struct TokenRun {		/* a scan of a piece */
+	ScannedToken *token;	/* grown with realloc, which need not copy */
+	int ntokens, size;
+	int stop;		/* the state it ended in, as scan_stop */
+	char *resume;		/* where that state starts */
+	int join;		/* the token of the first scan it goes on after, or -1 */
+	Arena strings;		/* its string constants, and what it echoed */
+
+	TokenRun() : token(NULL), ntokens(0), size(0), stop(0), resume(NULL),
+		     join(-1) { }
+	~TokenRun() { free(token); strings.clear(); }
+};
+
+struct Piece {
+	char *start, *end;
+	ScanInput *input;
+	TokenRun first;			/* from between tokens */
+	TokenRun comment[SPEC_DEPTH];	/* from a comment 1, 2, ... deep */
+	TokenRun again;			/* from where it really starts */
+};
+
+struct Segment {		/* tokens of a scan, handed out in turn */
+	TokenRun *run;
+	int next;
+};
+
+static __thread Piece *pieces;
+static __thread int npieces;
+static __thread Segment *segments;
+static __thread int nsegments;
+static __thread int next_segment;
+
+/*
+ *  A scan echoes to a stream without a buffer of its own, which collects
+ *  the text in echoed, to be taken from there after each token.
+ */
+static __thread char *echoed;
+static __thread size_t echoed_len, echoed_size;
+
+static ssize_t collect_echo(void *cookie, const char *buf, size_t size)
+{
+	if (echoed_len + size > echoed_size) {
+		echoed_size = 2 * (echoed_len + size);
+		echoed = (char *) realloc(echoed, echoed_size);
+	}
+	memcpy(echoed + echoed_len, buf, size);
+	echoed_len += size;
+	return size;
+}
+
+static ScannedToken *new_token(TokenRun *r)
+{
+	if (r->ntokens == r->size) {
+		r->size = r->size ? 2 * r->size : 1024;
+		r->token = (ScannedToken *) realloc(r->token,
+						    r->size * sizeof(ScannedToken));
+		if (r->token == NULL) {
+			fprintf(stderr, "out of memory scanning in pieces\n");
+			exit(1);
+		}
+	}
+	return &r->token[r->ntokens++];
+}
+
+static void add_token(TokenRun *r, int token, YYSTYPE *lval)
+{
+	if (echoed_len) {
+		ScannedToken *e = new_token(r);
+		e->token = ECHOED;
+		e->after = r->ntokens > 1 ? e[-1].after : 0;
+		e->lval.span.text = r->strings.copy_string(echoed, echoed_len);
+		e->lval.span.len = echoed_len;
+		echoed_len = 0;
+	}
+	if (token == ECHOED)
+		return;
+	ScannedToken *t = new_token(r);
+	t->token = token;
+	t->after = pos - scan_input.text;
+	t->lval = *lval;
+}
+
+/*
+ *  scan_run(r, from, layer, to, first) scans the text from `from' up to
+ *  `to' into r, starting in a comment `layer' deep, or between tokens if
+ *  layer is 0.  With a first scan, it stops once it meets it.
+ */
+static void scan_run(TokenRun *r, char *from, int layer, char *to,
+		     TokenRun *first)
+{
+	static cookie_io_functions_t collect = { NULL, collect_echo, NULL, NULL };
+	FILE *echo = fopencookie(NULL, "w", collect);
+	unsigned j = 0;	/* the first token of the first scan not ending before pos */
+
+	setvbuf(echo, NULL, _IONBF, 0);
+	echo_to = echo;
+	echoed_len = 0;
+	piece_strings = &r->strings;
+	pos = from;
+	end = to;
+	scan_stop = 0;
+	if (layer > 0) {
+		pos = skip_trivia(pos, end, &layer, echo);
+		if (layer > 0 && end == input_end) {	/* as scan_token */
+			YYSTYPE lval;
+			lval.error_msg = "EOF in comment.";
+			add_token(r, ERROR, &lval);
+		}
+		scan_stop = layer;
+	}
+	while (layer == 0) {
+		YYSTYPE lval;
+		int token = scan_token(&lval);
+		if (token == 0)
+			break;
+		add_token(r, token, &lval);
+		if (first) {
+			unsigned after = pos - scan_input.text;
+			while (j < (unsigned) first->ntokens && first->token[j].after < after)
+				j++;
+			if (j < (unsigned) first->ntokens && first->token[j].after == after) {
+				r->join = j;
+				break;
+			}
+		}
+	}
+	add_token(r, ECHOED, NULL);	/* what was echoed after the last token */
+	r->stop = scan_stop;
+	r->resume = pos;
+	fclose(echo);
+	echo_to = NULL;
+	piece_strings = NULL;
+}
+
+static void *scan_piece(void *arg)
+{
+	Piece *p = (Piece *) arg;
+
+	scan_input = *p->input;
+	input_end = scan_input.text + scan_input.len;
+	scan_run(&p->first, p->start, 0, p->end, NULL);
+	if (p->start != scan_input.text)
+		for (int k = 1; k <= SPEC_DEPTH; k++)
+			scan_run(&p->comment[k - 1], p->start, k, p->end, &p->first);
+	delete [] scratch;
+	scratch = NULL;
+	scratch_size = 0;
+	free(echoed);
+	echoed = NULL;
+	echoed_size = 0;
+	return NULL;
+}
+
+static void add_segment(TokenRun *r, int next)
+{
+	Segment &g = segments[nsegments++];
+	g.run = r;
+	g.next = next;
+}
+
+static void scan_in_pieces()
+{
+	ScanInput input = scan_input;	/* for the threads to copy */
+	char *text = input.text, *start = text;
+	size_t len = input.len;
+	int n = len / PIECE_MIN < (size_t) scan_threads ?
+		len / PIECE_MIN : scan_threads;
+
+	if (n < 2 || len > 0xffffffff)
+		return;
+	pieces = new Piece[n];
+	for (int i = 1; i <= n; i++) {
+		char *cut = input_end;
+		if (i < n) {
+			cut = (char *) memchr(text + len / n * i, '\n',
+					      input_end - (text + len / n * i));
+			cut = cut ? cut + 1 : input_end;
+		}
+		if (cut <= start)
+			continue;
+		Piece &p = pieces[npieces++];
+		p.start = start;
+		p.end = cut;
+		p.input = &input;
+		start = cut;
+	}
+
+	pthread_t *thread = new pthread_t[npieces];
+	bool *started = new bool[npieces];
+	for (int i = 1; i < npieces; i++)
+		started[i] = pthread_create(&thread[i], NULL, scan_piece,
+					    &pieces[i]) == 0;
+	scan_piece(&pieces[0]);
+	for (int i = 1; i < npieces; i++)
+		if (started[i])
+			pthread_join(thread[i], NULL);
+		else
+			scan_piece(&pieces[i]);
+	delete [] thread;
+	delete [] started;
+
+	/* each piece adds its chosen scan, and the rest of its first scan */
+	segments = new Segment[2 * npieces];
+	int stop = 0;
+	char *resume = NULL;
+	for (int i = 0; i < npieces; i++) {
+		Piece &p = pieces[i];
+		TokenRun *r;
+		if (stop == 0)
+			r = &p.first;
+		else if (stop > 0 && stop <= SPEC_DEPTH)
+			r = &p.comment[stop - 1];
+		else {
+			r = &p.again;
+			if (stop == STOP_STRING)
+				scan_run(r, resume, 0, p.end, &p.first);
+			else
+				scan_run(r, p.start, stop, p.end, &p.first);
+		}
+		add_segment(r, 0);
+		if (r->join >= 0) {
+			add_segment(&p.first, r->join + 1);
+			r = &p.first;
+		}
+		stop = r->stop;
+		resume = r->resume;
+	}
+	scan_input_seek_line(&scan_input, 0);
+	pos = end = input_end;
+}
+
+/* the next token of the pieces, as cool_scan_token */
+static int scanned_token(YYSTYPE *lval, int *lineno)
+{
+	for (; next_segment < nsegments; next_segment++) {
+		Segment &g = segments[next_segment];
+		while (g.next < g.run->ntokens) {
+			ScannedToken &t = g.run->token[g.next++];
+			if (t.token == ECHOED) {
+				fwrite(t.lval.span.text, 1, t.lval.span.len, yyout);
+				continue;
+			}
+			*lval = t.lval;
+			*lineno = scan_input_line(&scan_input,
+						  scan_input.text + t.after);
+			return t.token;
+		}
+	}
+	*lineno = scan_input.nnewlines + 1;
+	return 0;
+}
+
+/*
+ *  cool_scan_token(lval, lineno) is as in cool.flex: it returns the next
+ *  token, or 0 at the end, with its value in *lval and its line in
+ *  *lineno.  Lines are not counted as the text is scanned: the line of
+ *  a token is found from where it ends, with the line index of the
+ *  input (see scan-input.cc).
+ */
+int cool_scan_token(YYSTYPE *lval, int *lineno)
+{
+	if (npieces)
+		return scanned_token(lval, lineno);
+	int token = scan_token(lval);
+	*lineno = scan_input_line(&scan_input, pos);
+	return token;
+}
+
+/*
+ *  cool_scan_file(name) makes the file `name' the input of the scanner,
+ *  and returns 0 if it cannot be opened; cool_scan_end releases it.  As
+ *  with cool.flex, the tokens' spans point into the input until then.
+ */
+int cool_scan_file(char *name)
+{
+	if (!scan_input_open(name, &scan_input))
+		return 0;
+	pos = scan_input.text;
+	end = input_end = scan_input.text + scan_input.len;
+	if (scan_threads > 1)
+		scan_in_pieces();
+	return 1;
+}
+
+void cool_scan_end()
+{
+	if (pieces) {
+		delete [] pieces;
+		delete [] segments;
+		pieces = NULL;
+		segments = NULL;
+		npieces = nsegments = next_segment = 0;
+	}
+	delete [] scratch;
+	scratch = NULL;
+	scratch_size = 0;
+	free(echoed);
+	echoed = NULL;
+	echoed_size = 0;
+	if (scan_input.text)
+		scan_input_close(&scan_input);
+}
@@ -0,0 +1,393 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  lexbench.cc
+//
+//  Times the lexer (make bench).  With file arguments, it scans the
+//  files; with none, it makes inputs that are hard on a lexer, and scans
+//  those:
+//
+//      identifiers   type and object identifiers of thousands of letters
+//      strings       string constants of 1024 characters, full of escapes
+//      comments      comments nested hundreds deep
+//      integers      integer constants of thousands of digits
+//      lines         a million short lines
+//      keywords      keywords, true and false, in mixed case
+//
+//  Each input is scanned BENCH_RUNS times, and the best time is reported
+//  as MB/s and tokens/s.  Then the time taken to enter the identifiers
+//  and constants of the input into idtable, stringtable and inttable, as
+//  the parser does, is reported apart, in milliseconds per table.
+//
+//  The inputs are made in temporary files, which are removed at the end;
+//  with -o dir, they are made in dir and kept.  -C threads scans in
+//  pieces as the lexer does (see cool-scan.cc).
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "cool-parse.h"
+#include "stringtab.h"
+#include "utilities.h"
+
+__thread int curr_lineno = 1;
+__thread char *curr_filename = "<stdin>";
+FILE *fin;
+__thread YYSTYPE cool_yylval;
+int  cool_yydebug;
+
+extern int cool_scan_token(YYSTYPE *lval, int *lineno);
+extern int cool_scan_file(char *name);
+extern void cool_scan_end();
+
+extern int optind;
+extern FILE *yyout;
+extern char *out_filename;
+void handle_flags(int argc, char *argv[]);
+
+#define BENCH_RUNS  3
+#define BENCH_SIZE  (8 << 20)   // the size of most generated inputs
+#define BENCH_LINES 1000000     // the lines of the "lines" input
+
+//
+//  The generated inputs are the same from run to run: they are made from
+//  a pseudo-random sequence with a fixed seed.
+//
+static unsigned long bench_seed;
+
+static int random_below(int n)
+{
+	bench_seed = bench_seed * 6364136223846793005UL + 1442695040888963407UL;
+	return (int) ((bench_seed >> 33) % n);
+}
+
+static void put_letters(FILE *f, int len, bool upper_first)
+{
+	for (int i = 0; i < len; i++) {
+		int c = random_below(27);
+		if (c == 26 && i > 0)
+			putc('_', f);
+		else if (i == 0 && upper_first)
+			putc('A' + c % 26, f);
+		else
+			putc('a' + c % 26, f);
+	}
+}
+
+//
+//  Attributes and assignments whose identifiers are 1000 to 8000 letters
+//  long.  Most of the identifiers come from a few dozen that are used
+//  again and again, so that most of them are found in idtable rather than
+//  added; they differ in their last letters only.
+//
+static void make_identifiers(FILE *f)
+{
+	static char prefix[8000];
+	for (int i = 0; i < (int) sizeof(prefix); i++)
+		prefix[i] = 'a' + random_below(26);
+
+	while (ftell(f) < BENCH_SIZE) {
+		int len = 1000 + random_below(7000);
+		putc('X', f);
+		fwrite(prefix, 1, len, f);
+		put_letters(f, 1, false);
+		fputs(" : ", f);
+		fwrite(prefix, 1, len, f);
+		put_letters(f, random_below(2) + 1, false);
+		fputs(" <- ", f);
+		put_letters(f, 2 + random_below(6000), false);
+		fputs(";\n", f);
+	}
+}
+
+//
+//  String constants of just under 1024 characters, most of them escaped,
+//  some with escaped newlines, and one in a hundred too long.
+//
+static void make_strings(FILE *f)
+{
+	static const char *escapes[] = { "\\n", "\\t", "\\b", "\\f", "\\\"",
+					 "\\\\", "\\q", "\\\n" };
+
+	while (ftell(f) < BENCH_SIZE) {
+		int len = random_below(100) ? 1000 + random_below(23) : 1100;
+		fputs("s <- \"", f);
+		for (int i = 0; i < len; i++)
+			if (random_below(4))
+				fputs(escapes[random_below(8)], f);
+			else
+				putc('a' + random_below(26), f);
+		fputs("\";\n", f);
+	}
+}
+
+//
+//  Comments nested 1 to 500 deep, with text at each level.  An opening
+//  "(*" nests only at the start of a match, so the openings of a level
+//  run together or start a line (see skip_trivia in scan-input.cc).
+//
+static void make_comments(FILE *f)
+{
+	while (ftell(f) < BENCH_SIZE) {
+		int depth = 1 + random_below(500);
+		for (int i = 0; i < depth; i++) {
+			fputs("(*", f);
+			if (random_below(8) == 0)
+				fputs(" the comment goes on (\n", f);
+		}
+		fputs(" innermost ( ) text \n-- and a line comment\n", f);
+		for (int i = 0; i < depth; i++)
+			fputs(random_below(8) ? "*)" : ") *)", f);
+		fputs("\n-- a line comment (* that does not open one\n", f);
+	}
+}
+
+//
+//  Integer constants of 1000 to 10000 digits, some of them the same.
+//
+static void make_integers(FILE *f)
+{
+	while (ftell(f) < BENCH_SIZE) {
+		int len = 1000 + random_below(9000);
+		fputs("i <- ", f);
+		if (random_below(4) == 0) {
+			for (int i = 0; i < len; i++)
+				putc('7', f);
+		} else {
+			putc('1' + random_below(9), f);
+			for (int i = 1; i < len; i++)
+				putc('0' + random_below(10), f);
+		}
+		fputs(" + 0;\n", f);
+	}
+}
+
+//
+//  BENCH_LINES short lines, some of them empty.
+//
+static void make_lines(FILE *f)
+{
+	static const char *lines[] = { "x <- y;\n", "\n", "i <- i + 1;\n",
+				       "  {\n", "  }\n", "\t(* c *)\n",
+				       "if a then b else c fi;\n", "-- c\n" };
+
+	for (int i = 0; i < BENCH_LINES; i++)
+		fputs(lines[random_below(8)], f);
+}
+
+//
+//  Keywords, and true and false, with their letters in random case (but
+//  for the first letter of true and false, which must be lower case).
+//
+static void make_keywords(FILE *f)
+{
+	static const char *keywords[] = { "class", "inherits", "if", "then",
+					  "else", "fi", "while", "loop", "pool",
+					  "let", "in", "case", "of", "esac",
+					  "new", "isvoid", "not", "true",
+					  "false" };
+	int nkeywords = sizeof(keywords) / sizeof(keywords[0]);
+
+	while (ftell(f) < BENCH_SIZE) {
+		for (int i = 0; i < 12; i++) {
+			const char *k = keywords[random_below(nkeywords)];
+			for (int j = 0; k[j]; j++) {
+				bool lower = random_below(2) ||
+					(j == 0 && (k[0] == 't' || k[0] == 'f'));
+				putc(lower ? k[j] : k[j] - 'a' + 'A', f);
+			}
+			putc(' ', f);
+		}
+		putc('\n', f);
+	}
+}
+
+static struct {
+	const char *name;
+	void (*make)(FILE *f);
+} generated[] = {
+	{ "identifiers", make_identifiers },
+	{ "strings",     make_strings },
+	{ "comments",    make_comments },
+	{ "integers",    make_integers },
+	{ "lines",       make_lines },
+	{ "keywords",    make_keywords },
+};
+
+#define NGENERATED  ((int) (sizeof(generated) / sizeof(generated[0])))
+
+// make the generated input i, returning the name of its file
+static char *make_input(int i, const char *dir)
+{
+	char *name = new char[strlen(dir) + 64];
+	FILE *f;
+
+	if (out_filename) {
+		sprintf(name, "%s/%s.cl", dir, generated[i].name);
+		f = fopen(name, "w");
+	} else {
+		sprintf(name, "%s/lexbench-%s-XXXXXX", dir, generated[i].name);
+		int fd = mkstemp(name);
+		f = fd < 0 ? NULL : fdopen(fd, "w");
+	}
+	if (f == NULL) {
+		cerr << "Could not create input file " << name << endl;
+		exit(1);
+	}
+	bench_seed = i + 1;
+	generated[i].make(f);
+	if (fclose(f) != 0) {
+		cerr << "Could not write input file " << name << endl;
+		exit(1);
+	}
+	return name;
+}
+
+static double now()
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void open_input(char *name)
+{
+	if (!cool_scan_file(name)) {
+		cerr << "Could not open input file " << name << endl;
+		exit(1);
+	}
+	curr_lineno = 1;
+}
+
+//
+//  The spans of the identifiers and constants of an input, by the table
+//  they go into.
+//
+enum { ID_SPANS, STRING_SPANS, INT_SPANS, NSPANS };
+
+static Span *spans[NSPANS];
+static int nspans[NSPANS];
+static int spans_size[NSPANS];
+
+static void add_span(int t, Span span)
+{
+	if (nspans[t] == spans_size[t]) {
+		spans_size[t] = spans_size[t] ? 2 * spans_size[t] : 4096;
+		Span *s = new Span[spans_size[t]];
+		memcpy(s, spans[t], nspans[t] * sizeof(Span));
+		delete [] spans[t];
+		spans[t] = s;
+	}
+	spans[t][nspans[t]++] = span;
+}
+
+template <class Elem> static double time_adds(StringTable<Elem> &tbl, int t)
+{
+	double start = now();
+	for (int i = 0; i < nspans[t]; i++)
+		tbl.add_chars(spans[t][i].text, spans[t][i].len);
+	return now() - start;
+}
+
+//
+//  Scans the file `name' and prints a line of its times.
+//
+static void bench(char *name, const char *label)
+{
+	YYSTYPE lval;
+	int lineno, token;
+	long bytes = 0, ntokens = 0;
+	double best = 0, intern[NSPANS] = { 0, 0, 0 };
+
+	FILE *f = fopen(name, "r");
+	if (f != NULL) {
+		fseek(f, 0, SEEK_END);
+		bytes = ftell(f);
+		fclose(f);
+	}
+
+	for (int run = 0; run < BENCH_RUNS; run++) {
+		double start = now();
+		open_input(name);
+		ntokens = 0;
+		while (cool_scan_token(&lval, &lineno) != 0)
+			ntokens++;
+		cool_scan_end();
+		double t = now() - start;
+		if (run == 0 || t < best)
+			best = t;
+	}
+
+	//
+	//  The spans point into the input, so the tables are filled before
+	//  it is released.  They are emptied before each run, so that every
+	//  run adds the same entries.
+	//
+	open_input(name);
+	nspans[ID_SPANS] = nspans[STRING_SPANS] = nspans[INT_SPANS] = 0;
+	while ((token = cool_scan_token(&lval, &lineno)) != 0)
+		switch (token) {
+		case TYPEID:
+		case OBJECTID:  add_span(ID_SPANS, lval.span); break;
+		case STR_CONST: add_span(STRING_SPANS, lval.span); break;
+		case INT_CONST: add_span(INT_SPANS, lval.span); break;
+		}
+	for (int run = 0; run < BENCH_RUNS; run++) {
+		idtable.clear();
+		stringtable.clear();
+		inttable.clear();
+		double t[NSPANS];
+		t[ID_SPANS] = time_adds(idtable, ID_SPANS);
+		t[STRING_SPANS] = time_adds(stringtable, STRING_SPANS);
+		t[INT_SPANS] = time_adds(inttable, INT_SPANS);
+		for (int i = 0; i < NSPANS; i++)
+			if (run == 0 || t[i] < intern[i])
+				intern[i] = t[i];
+	}
+	cool_scan_end();
+
+	printf("%-12s %8.1f %10ld %9.1f %9.2f %10.2f %9.2f %9.2f\n", label,
+	       bytes / 1e6, ntokens, bytes / 1e6 / best, ntokens / 1e6 / best,
+	       intern[ID_SPANS] * 1e3, intern[STRING_SPANS] * 1e3,
+	       intern[INT_SPANS] * 1e3);
+	fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+	handle_flags(argc, argv);
+
+	// Text that no rule matches is echoed by the scanner; not here.
+	yyout = fopen("/dev/null", "w");
+
+	printf("%-12s %8s %10s %9s %9s %10s %9s %9s\n", "input", "MB", "tokens",
+	       "MB/s", "Mtok/s", "idtable", "strings", "ints");
+	printf("%-12s %8s %10s %9s %9s %10s %9s %9s\n", "", "", "", "", "",
+	       "(ms)", "(ms)", "(ms)");
+
+	if (optind < argc) {
+		for (; optind < argc; optind++)
+			bench(argv[optind], argv[optind]);
+		exit(0);
+	}
+
+	const char *dir = out_filename;
+	if (dir == NULL && (dir = getenv("TMPDIR")) == NULL)
+		dir = "/tmp";
+	for (int i = 0; i < NGENERATED; i++) {
+		char *name = make_input(i, dir);
+		bench(name, generated[i].name);
+		if (!out_filename)
+			unlink(name);
+		delete [] name;
+	}
+	exit(0);
+}
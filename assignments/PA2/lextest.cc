@@ -18,30 +18,47 @@
 #include <unistd.h>     // for getopt
 #include "cool-parse.h" // bison-generated file; defines tokens
 #include "utilities.h"
+#include "token-stream.h"
 
 //
-//  The lexer keeps this global variable up to date with the line number
-//  of the current line read from the input.
+//  The number of the line that the last token scanned ends on, as the
+//  scanner returns it.
 //
-int curr_lineno = 1;
-char *curr_filename = "<stdin>"; // this name is arbitrary
+__thread int curr_lineno = 1;
+__thread char *curr_filename = "<stdin>"; // this name is arbitrary
 FILE *fin;   // This is the file pointer from which the lexer reads its input.
 
 //
-//  cool_yylex() is the function produced by flex. It returns the next
-//  token each time it is called.
+//  cool_scan_token(&lval, &lineno) returns the next token each time it is
+//  called, with its value and line.  It is defined by the scanner, from
+//  the function produced by flex (see cool.flex).  The tokens are printed
+//  from cool_yylval, as the parser would take them.
 //
-extern int cool_yylex();
-YYSTYPE cool_yylval;           // Not compiled with parser, so must define this.
+extern int cool_scan_token(YYSTYPE *lval, int *lineno);
+__thread YYSTYPE cool_yylval;           // Not compiled with parser, so must define this.
+
+//
+//  cool_scan_file(name) makes the file the lexer's input, mapping it into
+//  memory when it can; cool_scan_end() releases it.  Both are defined by
+//  the scanner: cool.flex, or cool-scan.cc (see the Makefile).
+//
+extern int cool_scan_file(char *name);
+extern void cool_scan_end();
 
 extern int optind;  // used for option processing (man 3 getopt for more info)
 
 //
 //  Option -v sets the lex_verbose flag. The main() function prints out tokens
 //  if the program is invoked with option -v.  Option -l sets yy_flex_debug.
+//  Option -B sets binary_tokens: the tokens are written as a binary token
+//  stream (see token-stream.h) rather than as text, and the text the
+//  scanner echoes (as flex does with input that no rule matches) goes to
+//  yyout = stderr rather than into the stream.
 //
 extern int yy_flex_debug;      // Flex debugging; see flex documentation.
+extern FILE *yyout;            // Where the scanner echoes unmatched text.
 extern int lex_verbose;        // Controls printing of tokens.
+extern int binary_tokens;      // Write a binary token stream.
 void handle_flags(int argc, char *argv[]);
 
 //
@@ -61,10 +78,11 @@ int main(int argc, char** argv) {
 	int token;
 	
 	handle_flags(argc,argv);
+	if (binary_tokens)
+	    yyout = stderr;
 
 	while (optind < argc) {
-	    fin = fopen(argv[optind], "r");
-	    if (fin == NULL) {
+	    if (!cool_scan_file(argv[optind])) {
 		cerr << "Could not open input file " << argv[optind] << endl;
 		exit(1);
 	    }
@@ -77,13 +95,21 @@ int main(int argc, char** argv) {
 	    //
 	    // Scan and print all tokens.
 	    //
-	    cout << "#name \"" << argv[optind] << "\"" << endl;
-	    while ((token = cool_yylex()) != 0) {
-		dump_cool_token(cout, curr_lineno, token, cool_yylval);
+	    if (binary_tokens) {
+		write_binary_name(cout, argv[optind]);
+		while ((token = cool_scan_token(&cool_yylval, &curr_lineno)) != 0)
+		    write_binary_token(cout, curr_lineno, token, cool_yylval);
+	    } else {
+		cout << "#name \"" << argv[optind] << "\"" << endl;
+		while ((token = cool_scan_token(&cool_yylval, &curr_lineno)) != 0) {
+		    dump_cool_token(cout, curr_lineno, token, cool_yylval);
+		}
 	    }
-	    fclose(fin);
+	    cool_scan_end();
 	    optind++;
 	}
+	if (binary_tokens)
+	    flush_binary_tokens(cout);
 	exit(0);
 }
 
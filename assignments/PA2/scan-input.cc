@@ -0,0 +1,287 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  scan-input.cc
+//
+//  The input of the scanners: cool.flex, and the direct-coded scanner of
+//  cool-scan.cc, which is chosen over it with SCANNER=direct (see the
+//  Makefile).  Both scan a whole file in memory, and skip whitespace and
+//  comments with skip_trivia.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "scan-input.h"
+
+/*
+ *  Skipping whitespace and comments.
+ *
+ *  skip_trivia(p, end, &layer, out) returns the first character at or
+ *  after p that does not belong to whitespace or a comment; p must be
+ *  where the scanner would start its next match, with its rules.  layer
+ *  is the depth of comment nesting at p (commentLayer, in cool.flex), and
+ *  is updated.  If the text runs out (at end) inside a comment, end is
+ *  returned with layer still positive.  Newlines are not counted here:
+ *  line numbers come from the line index (see below).
+ *
+ *  It follows the rules of cool.flex exactly, quirks included.  A "(*"
+ *  inside a comment opens a nested one only where a match starts, that
+ *  is, not after other comment text on the same line, since [^*\n]*
+ *  takes the "(" as part of that text.  A "*" that does not close a
+ *  comment falls to the default rule, which echoes it to out.
+ *
+ *  The search for the end of a run of blanks, and for the next "*", or
+ *  newline followed by "(", in a comment, is done on 16-byte blocks with
+ *  SSE2 compares.
+ */
+
+/* p at the first character that is not a blank or newline */
+static char *skip_blanks(char *p, char *end)
+{
+	/*
+	 * Most runs are a newline and a little indentation, so the first
+	 * block is looked at a character at a time.
+	 */
+	char *first = end - p > 16 ? p + 16 : end;
+	for (; p < first; p++)
+		if (!IS_BLANK(*p))
+			return p;
+#ifdef __SSE2__
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i below = _mm_set1_epi8('\t' - 1);   /* \t \n \v \f \r */
+	const __m128i above = _mm_set1_epi8('\r' + 1);
+
+	while (end - p >= 16) {
+		__m128i b = _mm_loadu_si128((__m128i *) p);
+		__m128i blank = _mm_or_si128(_mm_cmpeq_epi8(b, space),
+			_mm_and_si128(_mm_cmpgt_epi8(b, below),
+				      _mm_cmplt_epi8(b, above)));
+		unsigned other = ~_mm_movemask_epi8(blank) & 0xffff;
+		if (other)
+			return p + __builtin_ctz(other);
+		p += 16;
+	}
+#endif
+	for (; p < end; p++)
+		if (!IS_BLANK(*p))
+			return p;
+	return end;
+}
+
+/* p at the next "*", or newline followed by "(", in comment text */
+static char *comment_stop(char *p, char *end)
+{
+#ifdef __SSE2__
+	const __m128i star = _mm_set1_epi8('*');
+	const __m128i paren = _mm_set1_epi8('(');
+	const __m128i newline = _mm_set1_epi8('\n');
+
+	while (end - p > 16) {          /* p[16] is looked at too */
+		__m128i b = _mm_loadu_si128((__m128i *) p);
+		__m128i next = _mm_loadu_si128((__m128i *) (p + 1));
+		unsigned stop = _mm_movemask_epi8(_mm_or_si128(
+			_mm_cmpeq_epi8(b, star),
+			_mm_and_si128(_mm_cmpeq_epi8(b, newline),
+				      _mm_cmpeq_epi8(next, paren))));
+		if (stop)
+			return p + __builtin_ctz(stop);
+		p += 16;
+	}
+#endif
+	for (; p < end; p++)
+		if (*p == '*' || (*p == '\n' && p + 1 < end && p[1] == '('))
+			return p;
+	return end;
+}
+
+char *skip_trivia(char *p, char *end, int *layer, FILE *out)
+{
+	for (;;) {
+		while (*layer > 0 && p < end) {         /* in a comment */
+			if (p[0] == '(' && p + 1 < end && p[1] == '*') {
+				(*layer)++;
+				p += 2;
+			} else if (p[0] == '*') {
+				if (p + 1 < end && p[1] == ')') {
+					(*layer)--;
+					p += 2;
+				} else {
+					putc('*', out);
+					p++;
+				}
+			} else if (p[0] == '\n')
+				p++;	/* a "(*" may follow */
+			else
+				p = comment_stop(p + 1, end);
+		}
+		if (*layer > 0)
+			return end;
+		p = skip_blanks(p, end);
+		if (p + 1 < end && p[0] == '-' && p[1] == '-') {
+			p = (char *) memchr(p, '\n', end - p);
+			if (p == NULL)
+				return end;
+		} else if (p + 1 < end && p[0] == '(' && p[1] == '*') {
+			*layer = 1;
+			p += 2;
+		} else
+			return p;
+	}
+}
+
+/*
+ *  Memory-mapped input.
+ *
+ *  A regular file is mapped into memory, to be scanned in place, so the
+ *  scanner never refills or copies its buffer.  The two null bytes after
+ *  the text (which yy_scan_buffer wants, and which end the text for the
+ *  direct scanner) come from an anonymous zero-filled mapping two bytes
+ *  longer than the file, over which the file is mapped; that supplies
+ *  them even when the file ends on a page boundary.  The mapping is
+ *  private and writable because the scanners write into the text: flex
+ *  puts a null after each token, and both decode string constants in
+ *  place.  Only the pages written to are copied.
+ *
+ *  Anything that cannot be mapped is read whole into a buffer of its
+ *  own, so that in either case the tokens' spans stay valid until the
+ *  input is closed.
+ */
+
+static void index_lines(ScanInput *in);
+
+bool scan_input_open(char *name, ScanInput *in)
+{
+	struct stat st;
+	int fd = open(name, O_RDONLY);
+
+	if (fd < 0)
+		return false;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+		long page = sysconf(_SC_PAGESIZE);
+		size_t len = st.st_size;
+		size_t size = (len + 2 + page - 1) / page * page;
+		char *base = (char *) mmap(NULL, size, PROT_READ | PROT_WRITE,
+					   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (base != MAP_FAILED && len > 0 &&
+		    mmap(base, len, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+			munmap(base, size);
+			base = (char *) MAP_FAILED;
+		}
+		if (base != MAP_FAILED) {
+			close(fd);
+			in->text = base;
+			in->len = len;
+			in->mapped = size;
+			index_lines(in);
+			return true;
+		}
+	}
+	size_t len = 0, size = 1 << 20;
+	ssize_t n;
+	char *base = new char[size];
+	for (;;) {
+		if (len + 2 == size) {
+			char *old_base = base;
+			base = new char[2 * size];
+			memcpy(base, old_base, len);
+			delete [] old_base;
+			size *= 2;
+		}
+		if ((n = read(fd, base + len, size - 2 - len)) <= 0)
+			break;
+		len += n;
+	}
+	close(fd);
+	base[len] = base[len + 1] = '\0';
+	in->text = base;
+	in->len = len;
+	in->mapped = 0;
+	index_lines(in);
+	return true;
+}
+
+void scan_input_close(ScanInput *in)
+{
+	if (in->mapped)
+		munmap(in->text, in->mapped);
+	else
+		delete [] in->text;
+	in->text = NULL;
+	delete [] in->newline;
+	in->newline = NULL;
+}
+
+/*
+ *  Line numbers.
+ *
+ *  The line of a token is worked out from where it ends in the text,
+ *  rather than counted by the scanner as it goes: it is one more than
+ *  the number of newlines before that point, and the rules of cool.flex
+ *  count every newline they scan, wherever it is, once.
+ *
+ *  The offsets of the newlines are found by index_lines, 16 bytes at a
+ *  time, when the file is opened: the scanners write into the text (see
+ *  above), and may write a newline, decoded from "\n", where there was
+ *  none.  Tokens are asked about in order, so scan_input_line (in
+ *  scan-input.h) looks on from the answer to the last question; a point
+ *  before it is looked up by binary search, in scan_input_seek_line.
+ */
+
+static void index_lines(ScanInput *in)
+{
+	char *text = in->text, *end = in->text + in->len;
+	int n = 0;
+
+	/* counted first, so the index is made at its size */
+	for (char *p = text; (p = (char *) memchr(p, '\n', end - p)); p++)
+		n++;
+	in->newline = new size_t[n + 1];
+	in->nnewlines = n;
+	in->line_hint = 0;
+
+	size_t *nl = in->newline;
+	char *p = text;
+#ifdef __SSE2__
+	const __m128i newline = _mm_set1_epi8('\n');
+
+	for (; end - p >= 16; p += 16) {
+		unsigned m = _mm_movemask_epi8(
+			_mm_cmpeq_epi8(_mm_loadu_si128((__m128i *) p), newline));
+		for (; m; m &= m - 1)
+			*nl++ = p - text + __builtin_ctz(m);
+	}
+#endif
+	for (; p < end; p++)
+		if (*p == '\n')
+			*nl++ = p - text;
+	*nl = (size_t) -1;      /* after every offset */
+}
+
+int scan_input_seek_line(ScanInput *in, size_t offset)
+{
+	int lo = 0;             /* newline[hi] >= offset */
+	int hi = in->nnewlines;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (in->newline[mid] < offset)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	in->line_hint = lo;
+	return lo + 1;
+}
@@ -50,7 +50,7 @@
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
+#define YYPURE 1
 
 /* Push parsers.  */
 #define YYPUSH 0
@@ -66,27 +66,48 @@
 #define yydebug         cool_yydebug
 #define yynerrs         cool_yynerrs
 
-#define yylval          cool_yylval
-#define yychar          cool_yychar
-#define yylloc          cool_yylloc
 
 /* Copy the first part of user declarations.  */
 #line 6 "cool.y" /* yacc.c:339  */
-
   #include <iostream>
   #include "cool-tree.h"
   #include "stringtab.h"
   #include "utilities.h"
   
-  extern char *curr_filename;
+  extern __thread char *curr_filename;
+  
+  /* TYPEID, OBJECTID, INT_CONST and STR_CONST tokens carry the span of
+  their text in the lexer's input, which is interned only here, when a
+  node is built from the token.  When several files are parsed at once,
+  on threads of their own (coolc -j), each thread enters its strings
+  through symbol_caches, caches of its own in front of the tables (see
+  StringTableCache in stringtab.h). */
+  __thread SymbolCaches *symbol_caches;
+  
+  static Symbol id_symbol(Span s)
+  {
+    return symbol_caches ? symbol_caches->ids.add_chars(s.text, s.len)
+                         : idtable.add_chars(s.text, s.len);
+  }
+  static Symbol int_symbol(Span s)
+  {
+    return symbol_caches ? symbol_caches->ints.add_chars(s.text, s.len)
+                         : inttable.add_chars(s.text, s.len);
+  }
+  static Symbol string_symbol(Span s)
+  {
+    return symbol_caches ? symbol_caches->strings.add_chars(s.text, s.len)
+                         : stringtable.add_chars(s.text, s.len);
+  }
+  static Symbol id_symbol(char *s)     { Span sp = { s, (int) strlen(s) }; return id_symbol(sp); }
+  static Symbol string_symbol(char *s) { Span sp = { s, (int) strlen(s) }; return string_symbol(sp); }
   
   
   /* Locations */
-  #define YYLTYPE int              /* the type of locations */
-  #define cool_yylloc curr_lineno  /* use the curr_lineno from the lexer
-  for the location of tokens */
+  #define YYLTYPE int              /* the type of locations: the line of
+  the token, from curr_lineno */
     
-    extern int node_lineno;          /* set before constructing a tree node
+    extern __thread int node_lineno;          /* set before constructing a tree node
     to whatever you want the line number
     for the tree node to be */
       
@@ -143,18 +164,21 @@
     
     
     
-    void yyerror(char *s);        /*  defined below; called for each parse error */
-    extern int yylex();           /*  the entry point to the lexer  */
+    void yyerror(YYLTYPE *loc, char *s);  /*  defined below; called for each parse error */
+    extern int cool_yylex();      /*  the entry point to the lexer  */
+    #undef yylex                  /*  ... which yylex, below, calls */
     
     /************************************************************************/
     /*                DONT CHANGE ANYTHING IN THIS SECTION                  */
     
-    Program ast_root;	      /* the result of the parse  */
-    Classes parse_results;        /* for use in semantic analysis */
-    int omerrs = 0;               /* number of errors in lexing and parsing */
+    /* The state of a parse is kept one per thread, so that several
+    threads can parse at once; see coolc.cc. */
+    __thread Program ast_root;	      /* the result of the parse  */
+    __thread Classes parse_results;        /* for use in semantic analysis */
+    __thread int omerrs = 0;               /* number of errors in lexing and parsing */
+    __thread ostream *parse_errors = &cerr;   /* where yyerror reports them */
     
-
-#line 158 "cool.tab.c" /* yacc.c:339  */
+#line 165 "cool.tab.c" /* yacc.c:339  */
 
 # ifndef YY_NULLPTR
 #  if defined __cplusplus && 201103L <= __cplusplus
@@ -253,7 +277,7 @@ union YYSTYPE
 #line 89 "cool.y" /* yacc.c:355  */
 
       Boolean boolean;
-      Symbol symbol;
+      Span span;
       Program program;
       Class_ class_;
       Classes classes;
@@ -268,7 +292,7 @@ union YYSTYPE
       char *error_msg;
     
 
-#line 272 "cool.tab.c" /* yacc.c:355  */
+#line 279 "cool.tab.c" /* yacc.c:355  */
 };
 
 typedef union YYSTYPE YYSTYPE;
@@ -291,15 +315,30 @@ struct YYLTYPE
 #endif
 
 
-extern YYSTYPE cool_yylval;
-extern YYLTYPE cool_yylloc;
+
 int cool_yyparse (void);
 
 #endif /* !YY_COOL_YY_COOL_TAB_H_INCLUDED  */
 
 /* Copy the second part of user declarations.  */
-
-#line 303 "cool.tab.c" /* yacc.c:358  */
+#line 136 "cool.y" /* yacc.c:358  */
+    /* The parser is pure: the lookahead token is kept in variables of
+    cool_yyparse, not in globals.  The lexer hands each token on in
+    cool_yylval and curr_lineno, of which there is one per thread, and
+    yylex passes it on to the parser, keeping the token for yyerror. */
+    __thread YYSTYPE cool_yylval;
+    __thread int curr_lineno = 1;
+    static __thread int lookahead;
+    
+    static int yylex(YYSTYPE *lval, YYLTYPE *lloc)
+    {
+      lookahead = cool_yylex();
+      *lval = cool_yylval;
+      *lloc = curr_lineno;
+      return lookahead;
+    }
+    
+#line 330 "cool.tab.c" /* yacc.c:358  */
 
 #ifdef short
 # undef short
@@ -857,7 +896,7 @@ do                                                              \
     }                                                           \
   else                                                          \
     {                                                           \
-      yyerror (YY_("syntax error: cannot back up")); \
+      yyerror (&yylloc, YY_("syntax error: cannot back up")); \
       YYERROR;                                                  \
     }                                                           \
 while (0)
@@ -1326,28 +1365,34 @@ yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocatio
 
 
 
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (void)
+{
 /* The lookahead symbol.  */
 int yychar;
 
+
 /* The semantic value of the lookahead symbol.  */
-YYSTYPE yylval;
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
 /* Location data for the lookahead symbol.  */
-YYLTYPE yylloc
+static YYLTYPE yyloc_default
 # if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
   = { 1, 1, 1, 1 }
 # endif
 ;
-/* Number of syntax errors so far.  */
-int yynerrs;
+YYLTYPE yylloc = yyloc_default;
 
+    /* Number of syntax errors so far.  */
+    int yynerrs;
 
-/*----------.
-| yyparse.  |
-`----------*/
-
-int
-yyparse (void)
-{
     int yystate;
     /* Number of tokens to shift before error messages enabled.  */
     int yyerrstatus;
@@ -1519,7 +1564,7 @@ yybackup:
   if (yychar == YYEMPTY)
     {
       YYDPRINTF ((stderr, "Reading a token: "));
-      yychar = yylex ();
+      yychar = yylex (&yylval, &yylloc);
     }
 
   if (yychar <= YYEOF)
@@ -1605,7 +1650,7 @@ yyreduce:
       SET_NODELOC((yylsp[0]));
       ast_root = program((yyvsp[0].classes));
     }
-#line 1609 "cool.tab.c" /* yacc.c:1646  */
+#line 1616 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 3:
@@ -1616,7 +1661,7 @@ yyreduce:
       (yyval.classes) = single_Classes((yyvsp[0].class_));
       parse_results = (yyval.classes);
     }
-#line 1620 "cool.tab.c" /* yacc.c:1646  */
+#line 1627 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 4:
@@ -1627,7 +1672,7 @@ yyreduce:
       (yyval.classes) = append_Classes((yyvsp[-1].classes),single_Classes((yyvsp[0].class_)));
       parse_results = (yyval.classes);
     }
-#line 1631 "cool.tab.c" /* yacc.c:1646  */
+#line 1638 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 5:
@@ -1635,10 +1680,10 @@ yyreduce:
     {
       (yyloc) = (yylsp[-5]);
       SET_NODELOC((yylsp[-5]));
-      (yyval.class_) = class_((yyvsp[-4].symbol),idtable.add_string("Object"),(yyvsp[-2].features),
-    				        stringtable.add_string(curr_filename));
+      (yyval.class_) = class_(id_symbol((yyvsp[-4].span)),id_symbol("Object"),(yyvsp[-2].features),
+    				        string_symbol(curr_filename));
     }
-#line 1642 "cool.tab.c" /* yacc.c:1646  */
+#line 1649 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 6:
@@ -1646,9 +1691,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-7]);
       SET_NODELOC((yylsp[-7]));
-      (yyval.class_) = class_((yyvsp[-6].symbol),(yyvsp[-4].symbol),(yyvsp[-2].features),stringtable.add_string(curr_filename));
+      (yyval.class_) = class_(id_symbol((yyvsp[-6].span)),id_symbol((yyvsp[-4].span)),(yyvsp[-2].features),string_symbol(curr_filename));
     }
-#line 1652 "cool.tab.c" /* yacc.c:1646  */
+#line 1659 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 7:
@@ -1657,7 +1702,7 @@ yyreduce:
       (yyloc) = (yylsp[-1]);
       SET_NODELOC((yylsp[-1]));
     }
-#line 1661 "cool.tab.c" /* yacc.c:1646  */
+#line 1668 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 8:
@@ -1665,7 +1710,7 @@ yyreduce:
     { 
       (yyval.features) = nil_Features();
     }
-#line 1669 "cool.tab.c" /* yacc.c:1646  */
+#line 1676 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 9:
@@ -1675,7 +1720,7 @@ yyreduce:
       SET_NODELOC((yylsp[-1]));
       (yyval.features) = single_Features((yyvsp[-1].feature));
     }
-#line 1679 "cool.tab.c" /* yacc.c:1646  */
+#line 1686 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 10:
@@ -1685,7 +1730,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.features) = append_Features((yyvsp[-2].features), single_Features((yyvsp[-1].feature)));
     }
-#line 1689 "cool.tab.c" /* yacc.c:1646  */
+#line 1696 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 11:
@@ -1693,9 +1738,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-8]);
       SET_NODELOC((yylsp[-8]));
-      (yyval.feature) = method((yyvsp[-8].symbol), (yyvsp[-6].formals), (yyvsp[-3].symbol), (yyvsp[-1].expression));
+      (yyval.feature) = method(id_symbol((yyvsp[-8].span)), (yyvsp[-6].formals), id_symbol((yyvsp[-3].span)), (yyvsp[-1].expression));
     }
-#line 1699 "cool.tab.c" /* yacc.c:1646  */
+#line 1706 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 12:
@@ -1703,9 +1748,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-2]);
       SET_NODELOC((yylsp[-2]));
-      (yyval.feature) = attr((yyvsp[-2].symbol), (yyvsp[0].symbol), no_expr());
+      (yyval.feature) = attr(id_symbol((yyvsp[-2].span)), id_symbol((yyvsp[0].span)), no_expr());
     }
-#line 1709 "cool.tab.c" /* yacc.c:1646  */
+#line 1716 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 13:
@@ -1713,9 +1758,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-4]);
       SET_NODELOC((yylsp[-4]));
-      (yyval.feature) = attr((yyvsp[-4].symbol), (yyvsp[-2].symbol), (yyvsp[0].expression));
+      (yyval.feature) = attr(id_symbol((yyvsp[-4].span)), id_symbol((yyvsp[-2].span)), (yyvsp[0].expression));
     }
-#line 1719 "cool.tab.c" /* yacc.c:1646  */
+#line 1726 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 14:
@@ -1723,7 +1768,7 @@ yyreduce:
     { (yyloc) = (yylsp[0]);
       SET_NODELOC((yylsp[0]));
     }
-#line 1727 "cool.tab.c" /* yacc.c:1646  */
+#line 1734 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 15:
@@ -1731,7 +1776,7 @@ yyreduce:
     {
       (yyval.formals) = nil_Formals();
     }
-#line 1735 "cool.tab.c" /* yacc.c:1646  */
+#line 1742 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 16:
@@ -1741,7 +1786,7 @@ yyreduce:
       SET_NODELOC((yylsp[0]));
       (yyval.formals) = single_Formals((yyvsp[0].formal));
     }
-#line 1745 "cool.tab.c" /* yacc.c:1646  */
+#line 1752 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 17:
@@ -1751,7 +1796,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.formals) = append_Formals((yyvsp[-2].formals), single_Formals((yyvsp[0].formal)));
     }
-#line 1755 "cool.tab.c" /* yacc.c:1646  */
+#line 1762 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 18:
@@ -1759,9 +1804,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-2]);
       SET_NODELOC((yylsp[-2]));
-      (yyval.formal) = formal((yyvsp[-2].symbol), (yyvsp[0].symbol));
+      (yyval.formal) = formal(id_symbol((yyvsp[-2].span)), id_symbol((yyvsp[0].span)));
     }
-#line 1765 "cool.tab.c" /* yacc.c:1646  */
+#line 1772 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 19:
@@ -1769,9 +1814,9 @@ yyreduce:
     { 
       (yyloc) = (yylsp[-2]);
       SET_NODELOC((yylsp[-2]));
-      (yyval.expression) = assign((yyvsp[-2].symbol), (yyvsp[0].expression));
+      (yyval.expression) = assign(id_symbol((yyvsp[-2].span)), (yyvsp[0].expression));
     }
-#line 1775 "cool.tab.c" /* yacc.c:1646  */
+#line 1782 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 20:
@@ -1779,9 +1824,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-7]);
       SET_NODELOC((yylsp[-7]));
-      (yyval.expression) = static_dispatch((yyvsp[-7].expression), (yyvsp[-5].symbol), (yyvsp[-3].symbol), (yyvsp[-1].expressions));
+      (yyval.expression) = static_dispatch((yyvsp[-7].expression), id_symbol((yyvsp[-5].span)), id_symbol((yyvsp[-3].span)), (yyvsp[-1].expressions));
     }
-#line 1785 "cool.tab.c" /* yacc.c:1646  */
+#line 1792 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 21:
@@ -1789,9 +1834,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-5]);
       SET_NODELOC((yylsp[-5]));
-      (yyval.expression) = dispatch((yyvsp[-5].expression), (yyvsp[-3].symbol), (yyvsp[-1].expressions));
+      (yyval.expression) = dispatch((yyvsp[-5].expression), id_symbol((yyvsp[-3].span)), (yyvsp[-1].expressions));
     }
-#line 1795 "cool.tab.c" /* yacc.c:1646  */
+#line 1802 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 22:
@@ -1799,9 +1844,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-3]);
       SET_NODELOC((yylsp[-3]));
-      (yyval.expression) = dispatch(object(idtable.add_string("self")), (yyvsp[-3].symbol), (yyvsp[-1].expressions));
+      (yyval.expression) = dispatch(object(id_symbol("self")), id_symbol((yyvsp[-3].span)), (yyvsp[-1].expressions));
     }
-#line 1805 "cool.tab.c" /* yacc.c:1646  */
+#line 1812 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 23:
@@ -1811,7 +1856,7 @@ yyreduce:
       SET_NODELOC((yylsp[-6]));
       (yyval.expression) = cond((yyvsp[-5].expression), (yyvsp[-3].expression), (yyvsp[-1].expression));
     }
-#line 1815 "cool.tab.c" /* yacc.c:1646  */
+#line 1822 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 24:
@@ -1821,7 +1866,7 @@ yyreduce:
       SET_NODELOC((yylsp[-4]));
       (yyval.expression) = loop((yyvsp[-3].expression), (yyvsp[-1].expression));
     }
-#line 1825 "cool.tab.c" /* yacc.c:1646  */
+#line 1832 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 25:
@@ -1831,7 +1876,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = block((yyvsp[-1].expressions));
     }
-#line 1835 "cool.tab.c" /* yacc.c:1646  */
+#line 1842 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 26:
@@ -1841,7 +1886,7 @@ yyreduce:
       SET_NODELOC((yylsp[-1]));
       (yyval.expression) = (yyvsp[0].expression);
     }
-#line 1845 "cool.tab.c" /* yacc.c:1646  */
+#line 1852 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 27:
@@ -1851,7 +1896,7 @@ yyreduce:
       SET_NODELOC((yylsp[-4]));
       (yyval.expression) = typcase((yyvsp[-3].expression), (yyvsp[-1].cases));
     }
-#line 1855 "cool.tab.c" /* yacc.c:1646  */
+#line 1862 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 28:
@@ -1859,9 +1904,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-1]);
       SET_NODELOC((yylsp[-1]));
-      (yyval.expression) = new_((yyvsp[0].symbol));
+      (yyval.expression) = new_(id_symbol((yyvsp[0].span)));
     }
-#line 1865 "cool.tab.c" /* yacc.c:1646  */
+#line 1872 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 29:
@@ -1871,7 +1916,7 @@ yyreduce:
       SET_NODELOC((yylsp[-1]));
       (yyval.expression) = isvoid((yyvsp[0].expression));
     }
-#line 1875 "cool.tab.c" /* yacc.c:1646  */
+#line 1882 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 30:
@@ -1881,7 +1926,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = plus((yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 1885 "cool.tab.c" /* yacc.c:1646  */
+#line 1892 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 31:
@@ -1891,7 +1936,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = sub((yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 1895 "cool.tab.c" /* yacc.c:1646  */
+#line 1902 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 32:
@@ -1901,7 +1946,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = mul((yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 1905 "cool.tab.c" /* yacc.c:1646  */
+#line 1912 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 33:
@@ -1911,7 +1956,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = divide((yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 1915 "cool.tab.c" /* yacc.c:1646  */
+#line 1922 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 34:
@@ -1921,7 +1966,7 @@ yyreduce:
       SET_NODELOC((yylsp[-1]));
       (yyval.expression) = neg((yyvsp[0].expression));
     }
-#line 1925 "cool.tab.c" /* yacc.c:1646  */
+#line 1932 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 35:
@@ -1931,7 +1976,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = lt((yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 1935 "cool.tab.c" /* yacc.c:1646  */
+#line 1942 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 36:
@@ -1941,7 +1986,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = leq((yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 1945 "cool.tab.c" /* yacc.c:1646  */
+#line 1952 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 37:
@@ -1951,7 +1996,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = eq((yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 1955 "cool.tab.c" /* yacc.c:1646  */
+#line 1962 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 38:
@@ -1961,7 +2006,7 @@ yyreduce:
       SET_NODELOC((yylsp[-1]));
       (yyval.expression) = comp((yyvsp[0].expression));
     }
-#line 1965 "cool.tab.c" /* yacc.c:1646  */
+#line 1972 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 39:
@@ -1971,7 +2016,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = (yyvsp[-1].expression);
     }
-#line 1975 "cool.tab.c" /* yacc.c:1646  */
+#line 1982 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 40:
@@ -1979,9 +2024,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[0]);
       SET_NODELOC((yylsp[0]));
-      (yyval.expression) = object((yyvsp[0].symbol));
+      (yyval.expression) = object(id_symbol((yyvsp[0].span)));
     }
-#line 1985 "cool.tab.c" /* yacc.c:1646  */
+#line 1992 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 41:
@@ -1989,9 +2034,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[0]);
       SET_NODELOC((yylsp[0]));
-      (yyval.expression) = int_const((yyvsp[0].symbol));
+      (yyval.expression) = int_const(int_symbol((yyvsp[0].span)));
     }
-#line 1995 "cool.tab.c" /* yacc.c:1646  */
+#line 2002 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 42:
@@ -1999,9 +2044,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[0]);
       SET_NODELOC((yylsp[0]));
-      (yyval.expression) = string_const((yyvsp[0].symbol));
+      (yyval.expression) = string_const(string_symbol((yyvsp[0].span)));
     }
-#line 2005 "cool.tab.c" /* yacc.c:1646  */
+#line 2012 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 43:
@@ -2011,7 +2056,7 @@ yyreduce:
       SET_NODELOC((yylsp[0]));
       (yyval.expression) = bool_const((yyvsp[0].boolean));
     }
-#line 2015 "cool.tab.c" /* yacc.c:1646  */
+#line 2022 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 44:
@@ -2019,7 +2064,7 @@ yyreduce:
     {
       (yyval.expressions) = nil_Expressions();
     }
-#line 2023 "cool.tab.c" /* yacc.c:1646  */
+#line 2030 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 45:
@@ -2029,7 +2074,7 @@ yyreduce:
       SET_NODELOC((yylsp[0]));
       (yyval.expressions) = single_Expressions((yyvsp[0].expression));
     }
-#line 2033 "cool.tab.c" /* yacc.c:1646  */
+#line 2040 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 46:
@@ -2039,7 +2084,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expressions) = append_Expressions((yyvsp[-2].expressions), single_Expressions((yyvsp[0].expression)));
     }
-#line 2043 "cool.tab.c" /* yacc.c:1646  */
+#line 2050 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 47:
@@ -2049,7 +2094,7 @@ yyreduce:
       SET_NODELOC((yylsp[-1]));
       (yyval.expressions) = single_Expressions((yyvsp[-1].expression));
     }
-#line 2053 "cool.tab.c" /* yacc.c:1646  */
+#line 2060 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 48:
@@ -2059,7 +2104,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expressions) = append_Expressions((yyvsp[-2].expressions), single_Expressions((yyvsp[-1].expression)));
     }
-#line 2063 "cool.tab.c" /* yacc.c:1646  */
+#line 2070 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 49:
@@ -2067,9 +2112,10 @@ yyreduce:
     {
       (yyloc) = (yylsp[-1]);
       SET_NODELOC((yylsp[-1]));
+      (yyval.expressions) = nil_Expressions();
       yyerrok;
     }
-#line 2073 "cool.tab.c" /* yacc.c:1646  */
+#line 2081 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 50:
@@ -2077,9 +2123,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-4]);
       SET_NODELOC((yylsp[-4]));
-      (yyval.expression) = let((yyvsp[-4].symbol), (yyvsp[-2].symbol), no_expr(), (yyvsp[0].expression));
+      (yyval.expression) = let(id_symbol((yyvsp[-4].span)), id_symbol((yyvsp[-2].span)), no_expr(), (yyvsp[0].expression));
     }
-#line 2083 "cool.tab.c" /* yacc.c:1646  */
+#line 2091 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 51:
@@ -2087,9 +2133,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-6]);
       SET_NODELOC((yylsp[-6]));
-      (yyval.expression) = let((yyvsp[-6].symbol), (yyvsp[-4].symbol), (yyvsp[-2].expression), (yyvsp[0].expression));
+      (yyval.expression) = let(id_symbol((yyvsp[-6].span)), id_symbol((yyvsp[-4].span)), (yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 2093 "cool.tab.c" /* yacc.c:1646  */
+#line 2101 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 52:
@@ -2097,9 +2143,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-4]);
       SET_NODELOC((yylsp[-4]));
-      (yyval.expression) = let((yyvsp[-4].symbol), (yyvsp[-2].symbol), no_expr(), (yyvsp[0].expression));
+      (yyval.expression) = let(id_symbol((yyvsp[-4].span)), id_symbol((yyvsp[-2].span)), no_expr(), (yyvsp[0].expression));
     }
-#line 2103 "cool.tab.c" /* yacc.c:1646  */
+#line 2111 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 53:
@@ -2107,9 +2153,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-6]);
       SET_NODELOC((yylsp[-6]));
-      (yyval.expression) = let((yyvsp[-6].symbol), (yyvsp[-4].symbol), (yyvsp[-2].expression), (yyvsp[0].expression));
+      (yyval.expression) = let(id_symbol((yyvsp[-6].span)), id_symbol((yyvsp[-4].span)), (yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 2113 "cool.tab.c" /* yacc.c:1646  */
+#line 2121 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 54:
@@ -2118,7 +2164,7 @@ yyreduce:
       (yyloc) = (yylsp[-2]);
       SET_NODELOC((yylsp[-2]));
     }
-#line 2122 "cool.tab.c" /* yacc.c:1646  */
+#line 2130 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 55:
@@ -2126,9 +2172,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-5]);
       SET_NODELOC((yylsp[-5]));
-      (yyval.cases) = single_Cases(branch((yyvsp[-5].symbol), (yyvsp[-3].symbol), (yyvsp[-1].expression)));
+      (yyval.cases) = single_Cases(branch(id_symbol((yyvsp[-5].span)), id_symbol((yyvsp[-3].span)), (yyvsp[-1].expression)));
     }
-#line 2132 "cool.tab.c" /* yacc.c:1646  */
+#line 2140 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 56:
@@ -2136,13 +2182,13 @@ yyreduce:
     {
       (yyloc) = (yylsp[-6]);
       SET_NODELOC((yylsp[-6]));
-      (yyval.cases) = append_Cases((yyvsp[-6].cases), single_Cases(branch((yyvsp[-5].symbol), (yyvsp[-3].symbol), (yyvsp[-1].expression))));
+      (yyval.cases) = append_Cases((yyvsp[-6].cases), single_Cases(branch(id_symbol((yyvsp[-5].span)), id_symbol((yyvsp[-3].span)), (yyvsp[-1].expression))));
     }
-#line 2142 "cool.tab.c" /* yacc.c:1646  */
+#line 2150 "cool.tab.c" /* yacc.c:1646  */
     break;
 
 
-#line 2146 "cool.tab.c" /* yacc.c:1646  */
+#line 2154 "cool.tab.c" /* yacc.c:1646  */
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -2193,7 +2239,7 @@ yyerrlab:
     {
       ++yynerrs;
 #if ! YYERROR_VERBOSE
-      yyerror (YY_("syntax error"));
+      yyerror (&yylloc, YY_("syntax error"));
 #else
 # define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
                                         yyssp, yytoken)
@@ -2220,7 +2266,7 @@ yyerrlab:
                 yymsgp = yymsg;
               }
           }
-        yyerror (yymsgp);
+        yyerror (&yylloc, yymsgp);
         if (yysyntax_error_status == 2)
           goto yyexhaustedlab;
       }
@@ -2343,7 +2389,7 @@ yyabortlab:
 | yyexhaustedlab -- memory exhaustion comes here.  |
 `-------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (YY_("memory exhausted"));
+  yyerror (&yylloc, YY_("memory exhausted"));
   yyresult = 2;
   /* Fall through.  */
 #endif
@@ -2378,18 +2424,21 @@ yyreturn:
   return yyresult;
 }
 #line 527 "cool.y" /* yacc.c:1906  */
-
     
     /* This function is called automatically when Bison detects a parse error. */
-    void yyerror(char *s)
+    void yyerror(YYLTYPE *loc, char *s)
     {
-      extern int curr_lineno;
+      ostream &err = *parse_errors;
       
-      cerr << "\"" << curr_filename << "\", line " << curr_lineno << ": " \
+      err << "\"" << curr_filename << "\", line " << *loc << ": " \
       << s << " at or near ";
-      print_cool_token(yychar);
-      cerr << endl;
+      print_cool_token(err, lookahead);
+      err << endl;
       omerrs++;
       
-      if(omerrs>50) {fprintf(stdout, "More than 50 errors\n"); exit(1);}
+      /* A parse whose errors are kept for later goes on; whoever prints
+      them stops after 50 (see coolc.cc). */
+      if(omerrs>50 && parse_errors == &cerr) {fprintf(stdout, "More than 50 errors\n"); exit(1);}
     }
+    
+    
\ No newline at end of file
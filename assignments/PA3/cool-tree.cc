@@ -13,423 +13,725 @@
 
 
 // constructors' functions
-Program program_class::copy_Program()
+int program_class::children()
 {
-   return new program_class(classes->copy_list());
+   return 1;
 }
 
 
-void program_class::dump(ostream& stream, int n)
+tree_node *program_class::child(int i)
+{
+   return classes;
+}
+
+
+tree_node *program_class::copy_node(tree_node **kids)
+{
+   return new program_class((Classes) kids[0]);
+}
+
+
+int program_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "program\n";
-   classes->dump(stream, n+2);
+   return n+2;
+}
+
+
+int class__class::children()
+{
+   return 1;
 }
 
 
-Class_ class__class::copy_Class_()
+tree_node *class__class::child(int i)
 {
-   return new class__class(copy_Symbol(name), copy_Symbol(parent), features->copy_list(), copy_Symbol(filename));
+   return features;
 }
 
 
-void class__class::dump(ostream& stream, int n)
+tree_node *class__class::copy_node(tree_node **kids)
+{
+   return new class__class(copy_Symbol(name), copy_Symbol(parent), (Features) kids[0], copy_Symbol(filename));
+}
+
+
+int class__class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "class_\n";
    dump_Symbol(stream, n+2, name);
    dump_Symbol(stream, n+2, parent);
-   features->dump(stream, n+2);
+   return n+2;
+}
+
+
+void class__class::dump_post(ostream& stream, int n)
+{
    dump_Symbol(stream, n+2, filename);
 }
 
 
-Feature method_class::copy_Feature()
+int method_class::children()
+{
+   return 2;
+}
+
+
+tree_node *method_class::child(int i)
+{
+   tree_node *kids[] = { formals, expr };
+   return kids[i];
+}
+
+
+tree_node *method_class::copy_node(tree_node **kids)
 {
-   return new method_class(copy_Symbol(name), formals->copy_list(), copy_Symbol(return_type), expr->copy_Expression());
+   return new method_class(copy_Symbol(name), (Formals) kids[0], copy_Symbol(return_type), (Expression) kids[1]);
 }
 
 
-void method_class::dump(ostream& stream, int n)
+int method_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "method\n";
    dump_Symbol(stream, n+2, name);
-   formals->dump(stream, n+2);
+   return n+2;
+}
+
+
+void method_class::dump_in(ostream& stream, int n, int i)
+{
    dump_Symbol(stream, n+2, return_type);
-   expr->dump(stream, n+2);
 }
 
 
-Feature attr_class::copy_Feature()
+int attr_class::children()
 {
-   return new attr_class(copy_Symbol(name), copy_Symbol(type_decl), init->copy_Expression());
+   return 1;
 }
 
 
-void attr_class::dump(ostream& stream, int n)
+tree_node *attr_class::child(int i)
+{
+   return init;
+}
+
+
+tree_node *attr_class::copy_node(tree_node **kids)
+{
+   return new attr_class(copy_Symbol(name), copy_Symbol(type_decl), (Expression) kids[0]);
+}
+
+
+int attr_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "attr\n";
    dump_Symbol(stream, n+2, name);
    dump_Symbol(stream, n+2, type_decl);
-   init->dump(stream, n+2);
+   return n+2;
 }
 
 
-Formal formal_class::copy_Formal()
+tree_node *formal_class::copy_node(tree_node **kids)
 {
    return new formal_class(copy_Symbol(name), copy_Symbol(type_decl));
 }
 
 
-void formal_class::dump(ostream& stream, int n)
+int formal_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "formal\n";
    dump_Symbol(stream, n+2, name);
    dump_Symbol(stream, n+2, type_decl);
+   return n+2;
+}
+
+
+int branch_class::children()
+{
+   return 1;
 }
 
 
-Case branch_class::copy_Case()
+tree_node *branch_class::child(int i)
 {
-   return new branch_class(copy_Symbol(name), copy_Symbol(type_decl), expr->copy_Expression());
+   return expr;
 }
 
 
-void branch_class::dump(ostream& stream, int n)
+tree_node *branch_class::copy_node(tree_node **kids)
+{
+   return new branch_class(copy_Symbol(name), copy_Symbol(type_decl), (Expression) kids[0]);
+}
+
+
+int branch_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "branch\n";
    dump_Symbol(stream, n+2, name);
    dump_Symbol(stream, n+2, type_decl);
-   expr->dump(stream, n+2);
+   return n+2;
+}
+
+
+int assign_class::children()
+{
+   return 1;
 }
 
 
-Expression assign_class::copy_Expression()
+tree_node *assign_class::child(int i)
 {
-   return new assign_class(copy_Symbol(name), expr->copy_Expression());
+   return expr;
 }
 
 
-void assign_class::dump(ostream& stream, int n)
+tree_node *assign_class::copy_node(tree_node **kids)
+{
+   return new assign_class(copy_Symbol(name), (Expression) kids[0]);
+}
+
+
+int assign_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "assign\n";
    dump_Symbol(stream, n+2, name);
-   expr->dump(stream, n+2);
+   return n+2;
 }
 
 
-Expression static_dispatch_class::copy_Expression()
+int static_dispatch_class::children()
 {
-   return new static_dispatch_class(expr->copy_Expression(), copy_Symbol(type_name), copy_Symbol(name), actual->copy_list());
+   return 2;
 }
 
 
-void static_dispatch_class::dump(ostream& stream, int n)
+tree_node *static_dispatch_class::child(int i)
+{
+   tree_node *kids[] = { expr, actual };
+   return kids[i];
+}
+
+
+tree_node *static_dispatch_class::copy_node(tree_node **kids)
+{
+   return new static_dispatch_class((Expression) kids[0], copy_Symbol(type_name), copy_Symbol(name), (Expressions) kids[1]);
+}
+
+
+int static_dispatch_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "static_dispatch\n";
-   expr->dump(stream, n+2);
+   return n+2;
+}
+
+
+void static_dispatch_class::dump_in(ostream& stream, int n, int i)
+{
    dump_Symbol(stream, n+2, type_name);
    dump_Symbol(stream, n+2, name);
-   actual->dump(stream, n+2);
 }
 
 
-Expression dispatch_class::copy_Expression()
+int dispatch_class::children()
+{
+   return 2;
+}
+
+
+tree_node *dispatch_class::child(int i)
+{
+   tree_node *kids[] = { expr, actual };
+   return kids[i];
+}
+
+
+tree_node *dispatch_class::copy_node(tree_node **kids)
 {
-   return new dispatch_class(expr->copy_Expression(), copy_Symbol(name), actual->copy_list());
+   return new dispatch_class((Expression) kids[0], copy_Symbol(name), (Expressions) kids[1]);
 }
 
 
-void dispatch_class::dump(ostream& stream, int n)
+int dispatch_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "dispatch\n";
-   expr->dump(stream, n+2);
+   return n+2;
+}
+
+
+void dispatch_class::dump_in(ostream& stream, int n, int i)
+{
    dump_Symbol(stream, n+2, name);
-   actual->dump(stream, n+2);
 }
 
 
-Expression cond_class::copy_Expression()
+int cond_class::children()
+{
+   return 3;
+}
+
+
+tree_node *cond_class::child(int i)
+{
+   tree_node *kids[] = { pred, then_exp, else_exp };
+   return kids[i];
+}
+
+
+tree_node *cond_class::copy_node(tree_node **kids)
 {
-   return new cond_class(pred->copy_Expression(), then_exp->copy_Expression(), else_exp->copy_Expression());
+   return new cond_class((Expression) kids[0], (Expression) kids[1], (Expression) kids[2]);
 }
 
 
-void cond_class::dump(ostream& stream, int n)
+int cond_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "cond\n";
-   pred->dump(stream, n+2);
-   then_exp->dump(stream, n+2);
-   else_exp->dump(stream, n+2);
+   return n+2;
 }
 
 
-Expression loop_class::copy_Expression()
+int loop_class::children()
 {
-   return new loop_class(pred->copy_Expression(), body->copy_Expression());
+   return 2;
 }
 
 
-void loop_class::dump(ostream& stream, int n)
+tree_node *loop_class::child(int i)
+{
+   tree_node *kids[] = { pred, body };
+   return kids[i];
+}
+
+
+tree_node *loop_class::copy_node(tree_node **kids)
+{
+   return new loop_class((Expression) kids[0], (Expression) kids[1]);
+}
+
+
+int loop_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "loop\n";
-   pred->dump(stream, n+2);
-   body->dump(stream, n+2);
+   return n+2;
+}
+
+
+int typcase_class::children()
+{
+   return 2;
 }
 
 
-Expression typcase_class::copy_Expression()
+tree_node *typcase_class::child(int i)
 {
-   return new typcase_class(expr->copy_Expression(), cases->copy_list());
+   tree_node *kids[] = { expr, cases };
+   return kids[i];
 }
 
 
-void typcase_class::dump(ostream& stream, int n)
+tree_node *typcase_class::copy_node(tree_node **kids)
+{
+   return new typcase_class((Expression) kids[0], (Cases) kids[1]);
+}
+
+
+int typcase_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "typcase\n";
-   expr->dump(stream, n+2);
-   cases->dump(stream, n+2);
+   return n+2;
 }
 
 
-Expression block_class::copy_Expression()
+int block_class::children()
 {
-   return new block_class(body->copy_list());
+   return 1;
 }
 
 
-void block_class::dump(ostream& stream, int n)
+tree_node *block_class::child(int i)
+{
+   return body;
+}
+
+
+tree_node *block_class::copy_node(tree_node **kids)
+{
+   return new block_class((Expressions) kids[0]);
+}
+
+
+int block_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "block\n";
-   body->dump(stream, n+2);
+   return n+2;
 }
 
 
-Expression let_class::copy_Expression()
+int let_class::children()
 {
-   return new let_class(copy_Symbol(identifier), copy_Symbol(type_decl), init->copy_Expression(), body->copy_Expression());
+   return 2;
 }
 
 
-void let_class::dump(ostream& stream, int n)
+tree_node *let_class::child(int i)
+{
+   tree_node *kids[] = { init, body };
+   return kids[i];
+}
+
+
+tree_node *let_class::copy_node(tree_node **kids)
+{
+   return new let_class(copy_Symbol(identifier), copy_Symbol(type_decl), (Expression) kids[0], (Expression) kids[1]);
+}
+
+
+int let_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "let\n";
    dump_Symbol(stream, n+2, identifier);
    dump_Symbol(stream, n+2, type_decl);
-   init->dump(stream, n+2);
-   body->dump(stream, n+2);
+   return n+2;
+}
+
+
+int plus_class::children()
+{
+   return 2;
+}
+
+
+tree_node *plus_class::child(int i)
+{
+   tree_node *kids[] = { e1, e2 };
+   return kids[i];
 }
 
 
-Expression plus_class::copy_Expression()
+tree_node *plus_class::copy_node(tree_node **kids)
 {
-   return new plus_class(e1->copy_Expression(), e2->copy_Expression());
+   return new plus_class((Expression) kids[0], (Expression) kids[1]);
 }
 
 
-void plus_class::dump(ostream& stream, int n)
+int plus_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "plus\n";
-   e1->dump(stream, n+2);
-   e2->dump(stream, n+2);
+   return n+2;
+}
+
+
+int sub_class::children()
+{
+   return 2;
 }
 
 
-Expression sub_class::copy_Expression()
+tree_node *sub_class::child(int i)
 {
-   return new sub_class(e1->copy_Expression(), e2->copy_Expression());
+   tree_node *kids[] = { e1, e2 };
+   return kids[i];
 }
 
 
-void sub_class::dump(ostream& stream, int n)
+tree_node *sub_class::copy_node(tree_node **kids)
+{
+   return new sub_class((Expression) kids[0], (Expression) kids[1]);
+}
+
+
+int sub_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "sub\n";
-   e1->dump(stream, n+2);
-   e2->dump(stream, n+2);
+   return n+2;
 }
 
 
-Expression mul_class::copy_Expression()
+int mul_class::children()
 {
-   return new mul_class(e1->copy_Expression(), e2->copy_Expression());
+   return 2;
 }
 
 
-void mul_class::dump(ostream& stream, int n)
+tree_node *mul_class::child(int i)
+{
+   tree_node *kids[] = { e1, e2 };
+   return kids[i];
+}
+
+
+tree_node *mul_class::copy_node(tree_node **kids)
+{
+   return new mul_class((Expression) kids[0], (Expression) kids[1]);
+}
+
+
+int mul_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "mul\n";
-   e1->dump(stream, n+2);
-   e2->dump(stream, n+2);
+   return n+2;
+}
+
+
+int divide_class::children()
+{
+   return 2;
+}
+
+
+tree_node *divide_class::child(int i)
+{
+   tree_node *kids[] = { e1, e2 };
+   return kids[i];
 }
 
 
-Expression divide_class::copy_Expression()
+tree_node *divide_class::copy_node(tree_node **kids)
 {
-   return new divide_class(e1->copy_Expression(), e2->copy_Expression());
+   return new divide_class((Expression) kids[0], (Expression) kids[1]);
 }
 
 
-void divide_class::dump(ostream& stream, int n)
+int divide_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "divide\n";
-   e1->dump(stream, n+2);
-   e2->dump(stream, n+2);
+   return n+2;
 }
 
 
-Expression neg_class::copy_Expression()
+int neg_class::children()
 {
-   return new neg_class(e1->copy_Expression());
+   return 1;
 }
 
 
-void neg_class::dump(ostream& stream, int n)
+tree_node *neg_class::child(int i)
+{
+   return e1;
+}
+
+
+tree_node *neg_class::copy_node(tree_node **kids)
+{
+   return new neg_class((Expression) kids[0]);
+}
+
+
+int neg_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "neg\n";
-   e1->dump(stream, n+2);
+   return n+2;
 }
 
 
-Expression lt_class::copy_Expression()
+int lt_class::children()
 {
-   return new lt_class(e1->copy_Expression(), e2->copy_Expression());
+   return 2;
 }
 
 
-void lt_class::dump(ostream& stream, int n)
+tree_node *lt_class::child(int i)
+{
+   tree_node *kids[] = { e1, e2 };
+   return kids[i];
+}
+
+
+tree_node *lt_class::copy_node(tree_node **kids)
+{
+   return new lt_class((Expression) kids[0], (Expression) kids[1]);
+}
+
+
+int lt_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "lt\n";
-   e1->dump(stream, n+2);
-   e2->dump(stream, n+2);
+   return n+2;
+}
+
+
+int eq_class::children()
+{
+   return 2;
+}
+
+
+tree_node *eq_class::child(int i)
+{
+   tree_node *kids[] = { e1, e2 };
+   return kids[i];
 }
 
 
-Expression eq_class::copy_Expression()
+tree_node *eq_class::copy_node(tree_node **kids)
 {
-   return new eq_class(e1->copy_Expression(), e2->copy_Expression());
+   return new eq_class((Expression) kids[0], (Expression) kids[1]);
 }
 
 
-void eq_class::dump(ostream& stream, int n)
+int eq_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "eq\n";
-   e1->dump(stream, n+2);
-   e2->dump(stream, n+2);
+   return n+2;
 }
 
 
-Expression leq_class::copy_Expression()
+int leq_class::children()
 {
-   return new leq_class(e1->copy_Expression(), e2->copy_Expression());
+   return 2;
 }
 
 
-void leq_class::dump(ostream& stream, int n)
+tree_node *leq_class::child(int i)
+{
+   tree_node *kids[] = { e1, e2 };
+   return kids[i];
+}
+
+
+tree_node *leq_class::copy_node(tree_node **kids)
+{
+   return new leq_class((Expression) kids[0], (Expression) kids[1]);
+}
+
+
+int leq_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "leq\n";
-   e1->dump(stream, n+2);
-   e2->dump(stream, n+2);
+   return n+2;
+}
+
+
+int comp_class::children()
+{
+   return 1;
 }
 
 
-Expression comp_class::copy_Expression()
+tree_node *comp_class::child(int i)
 {
-   return new comp_class(e1->copy_Expression());
+   return e1;
 }
 
 
-void comp_class::dump(ostream& stream, int n)
+tree_node *comp_class::copy_node(tree_node **kids)
+{
+   return new comp_class((Expression) kids[0]);
+}
+
+
+int comp_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "comp\n";
-   e1->dump(stream, n+2);
+   return n+2;
 }
 
 
-Expression int_const_class::copy_Expression()
+tree_node *int_const_class::copy_node(tree_node **kids)
 {
    return new int_const_class(copy_Symbol(token));
 }
 
 
-void int_const_class::dump(ostream& stream, int n)
+int int_const_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "int_const\n";
    dump_Symbol(stream, n+2, token);
+   return n+2;
 }
 
 
-Expression bool_const_class::copy_Expression()
+tree_node *bool_const_class::copy_node(tree_node **kids)
 {
    return new bool_const_class(copy_Boolean(val));
 }
 
 
-void bool_const_class::dump(ostream& stream, int n)
+int bool_const_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "bool_const\n";
    dump_Boolean(stream, n+2, val);
+   return n+2;
 }
 
 
-Expression string_const_class::copy_Expression()
+tree_node *string_const_class::copy_node(tree_node **kids)
 {
    return new string_const_class(copy_Symbol(token));
 }
 
 
-void string_const_class::dump(ostream& stream, int n)
+int string_const_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "string_const\n";
    dump_Symbol(stream, n+2, token);
+   return n+2;
 }
 
 
-Expression new__class::copy_Expression()
+tree_node *new__class::copy_node(tree_node **kids)
 {
    return new new__class(copy_Symbol(type_name));
 }
 
 
-void new__class::dump(ostream& stream, int n)
+int new__class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "new_\n";
    dump_Symbol(stream, n+2, type_name);
+   return n+2;
+}
+
+
+int isvoid_class::children()
+{
+   return 1;
+}
+
+
+tree_node *isvoid_class::child(int i)
+{
+   return e1;
 }
 
 
-Expression isvoid_class::copy_Expression()
+tree_node *isvoid_class::copy_node(tree_node **kids)
 {
-   return new isvoid_class(e1->copy_Expression());
+   return new isvoid_class((Expression) kids[0]);
 }
 
 
-void isvoid_class::dump(ostream& stream, int n)
+int isvoid_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "isvoid\n";
-   e1->dump(stream, n+2);
+   return n+2;
 }
 
 
-Expression no_expr_class::copy_Expression()
+tree_node *no_expr_class::copy_node(tree_node **kids)
 {
    return new no_expr_class();
 }
 
 
-void no_expr_class::dump(ostream& stream, int n)
+int no_expr_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "no_expr\n";
+   return n+2;
 }
 
 
-Expression object_class::copy_Expression()
+tree_node *object_class::copy_node(tree_node **kids)
 {
    return new object_class(copy_Symbol(name));
 }
 
 
-void object_class::dump(ostream& stream, int n)
+int object_class::dump_pre(ostream& stream, int n)
 {
    stream << pad(n) << "object\n";
    dump_Symbol(stream, n+2, name);
+   return n+2;
 }
 
 
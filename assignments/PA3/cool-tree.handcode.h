@@ -5,11 +5,12 @@
 #define COOL_TREE_HANDCODE_H
 
 #include <iostream>
+#include <stdint.h>
 #include "tree.h"
 #include "cool.h"
 #include "stringtab.h"
 #define yylineno curr_lineno;
-extern int yylineno;
+extern __thread int yylineno;
 
 inline Boolean copy_Boolean(Boolean b) {return b; }
 inline void assert_Boolean(Boolean) {}
@@ -32,6 +33,7 @@ class Expression_class;
 typedef Expression_class *Expression;
 class Case_class;
 typedef Case_class *Case;
+class CompactAst;
 
 typedef list_node<Class_> Classes_class;
 typedef Classes_class *Classes;
@@ -45,62 +47,60 @@ typedef list_node<Case> Cases_class;
 typedef Cases_class *Cases;
 
 #define Program_EXTRAS                          \
-virtual void dump_with_types(ostream&, int) = 0; 
+virtual uint32_t encode(CompactAst&) = 0;       \
+virtual void dump_binary(ostream&) = 0;
 
 
 
 #define program_EXTRAS                          \
-void dump_with_types(ostream&, int);            
+uint32_t encode(CompactAst&);                   \
+uint32_t encode_node(CompactAst&, uint32_t *);  \
+void dump_binary(ostream&);
 
 #define Class__EXTRAS                   \
-virtual Symbol get_filename() = 0;      \
-virtual void dump_with_types(ostream&,int) = 0; 
+virtual Symbol get_filename() = 0;
 
 
 #define class__EXTRAS                                 \
-Symbol get_filename() { return filename; }             \
-void dump_with_types(ostream&,int);                    
+uint32_t encode_node(CompactAst&, uint32_t *);        \
+Symbol get_filename() { return filename; }
 
 
-#define Feature_EXTRAS                                        \
-virtual void dump_with_types(ostream&,int) = 0; 
+#define Feature_EXTRAS
 
 
 #define Feature_SHARED_EXTRAS                                       \
-void dump_with_types(ostream&,int);    
+uint32_t encode_node(CompactAst&, uint32_t *);
 
 
 
 
 
-#define Formal_EXTRAS                              \
-virtual void dump_with_types(ostream&,int) = 0;
+#define Formal_EXTRAS
 
 
 #define formal_EXTRAS                           \
-void dump_with_types(ostream&,int);
+uint32_t encode_node(CompactAst&, uint32_t *);
 
 
-#define Case_EXTRAS                             \
-virtual void dump_with_types(ostream& ,int) = 0;
+#define Case_EXTRAS
 
 
 #define branch_EXTRAS                                   \
-void dump_with_types(ostream& ,int);
+uint32_t encode_node(CompactAst&, uint32_t *);
 
 
 #define Expression_EXTRAS                    \
 Symbol type;                                 \
 Symbol get_type() { return type; }           \
 Expression set_type(Symbol s) { type = s; return this; } \
-virtual void dump_with_types(ostream&,int) = 0;  \
 void dump_type(ostream&, int);               \
 Expression_class() { type = (Symbol) NULL; }
 
 
 
 #define Expression_SHARED_EXTRAS           \
-void dump_with_types(ostream&,int); 
+uint32_t encode_node(CompactAst&, uint32_t *);
 
 
 #endif
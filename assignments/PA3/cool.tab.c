@@ -71,6 +71,13 @@
   
   extern char *curr_filename;
   
+  /* TYPEID, OBJECTID, INT_CONST and STR_CONST tokens carry the span of
+  their text in the lexer's input, which is interned only here, when a
+  node is built from the token. */
+  static Symbol id_symbol(Span s)     { return idtable.add_chars(s.text, s.len); }
+  static Symbol int_symbol(Span s)    { return inttable.add_chars(s.text, s.len); }
+  static Symbol string_symbol(Span s) { return stringtable.add_chars(s.text, s.len); }
+  
   
   /* Locations */
   #define YYLTYPE int              /* the type of locations */
@@ -145,7 +152,7 @@
     int omerrs = 0;               /* number of errors in lexing and parsing */
     
 
-#line 149 "cool.tab.c" /* yacc.c:339  */
+#line 156 "cool.tab.c" /* yacc.c:339  */
 
 # ifndef YY_NULLPTR
 #  if defined __cplusplus && 201103L <= __cplusplus
@@ -214,7 +221,7 @@ union YYSTYPE
 #line 89 "cool.y" /* yacc.c:355  */
 
       Boolean boolean;
-      Symbol symbol;
+      Span span;
       Program program;
       Class_ class_;
       Classes classes;
@@ -229,7 +236,7 @@ union YYSTYPE
       char *error_msg;
     
 
-#line 233 "cool.tab.c" /* yacc.c:355  */
+#line 240 "cool.tab.c" /* yacc.c:355  */
 };
 
 typedef union YYSTYPE YYSTYPE;
@@ -260,7 +267,7 @@ int yyparse (void);
 
 /* Copy the second part of user declarations.  */
 
-#line 264 "cool.tab.c" /* yacc.c:358  */
+#line 271 "cool.tab.c" /* yacc.c:358  */
 
 #ifdef short
 # undef short
@@ -1566,7 +1573,7 @@ yyreduce:
       SET_NODELOC((yylsp[0]));
       ast_root = program((yyvsp[0].classes));
     }
-#line 1570 "cool.tab.c" /* yacc.c:1646  */
+#line 1577 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 3:
@@ -1577,7 +1584,7 @@ yyreduce:
       (yyval.classes) = single_Classes((yyvsp[0].class_));
       parse_results = (yyval.classes);
     }
-#line 1581 "cool.tab.c" /* yacc.c:1646  */
+#line 1588 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 4:
@@ -1588,7 +1595,7 @@ yyreduce:
       (yyval.classes) = append_Classes((yyvsp[-1].classes),single_Classes((yyvsp[0].class_)));
       parse_results = (yyval.classes);
     }
-#line 1592 "cool.tab.c" /* yacc.c:1646  */
+#line 1599 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 5:
@@ -1596,10 +1603,10 @@ yyreduce:
     {
       (yyloc) = (yylsp[-5]);
       SET_NODELOC((yylsp[-5]));
-      (yyval.class_) = class_((yyvsp[-4].symbol),idtable.add_string("Object"),(yyvsp[-2].features),
+      (yyval.class_) = class_(id_symbol((yyvsp[-4].span)),idtable.add_string("Object"),(yyvsp[-2].features),
     				        stringtable.add_string(curr_filename));
     }
-#line 1603 "cool.tab.c" /* yacc.c:1646  */
+#line 1610 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 6:
@@ -1607,9 +1614,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-7]);
       SET_NODELOC((yylsp[-7]));
-      (yyval.class_) = class_((yyvsp[-6].symbol),(yyvsp[-4].symbol),(yyvsp[-2].features),stringtable.add_string(curr_filename));
+      (yyval.class_) = class_(id_symbol((yyvsp[-6].span)),id_symbol((yyvsp[-4].span)),(yyvsp[-2].features),stringtable.add_string(curr_filename));
     }
-#line 1613 "cool.tab.c" /* yacc.c:1646  */
+#line 1620 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 7:
@@ -1618,7 +1625,7 @@ yyreduce:
       (yyloc) = (yylsp[-1]);
       SET_NODELOC((yylsp[-1]));
     }
-#line 1622 "cool.tab.c" /* yacc.c:1646  */
+#line 1629 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 8:
@@ -1626,7 +1633,7 @@ yyreduce:
     { 
       (yyval.features) = nil_Features();
     }
-#line 1630 "cool.tab.c" /* yacc.c:1646  */
+#line 1637 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 9:
@@ -1636,7 +1643,7 @@ yyreduce:
       SET_NODELOC((yylsp[-1]));
       (yyval.features) = single_Features((yyvsp[-1].feature));
     }
-#line 1640 "cool.tab.c" /* yacc.c:1646  */
+#line 1647 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 10:
@@ -1646,7 +1653,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.features) = append_Features((yyvsp[-2].features), single_Features((yyvsp[-1].feature)));
     }
-#line 1650 "cool.tab.c" /* yacc.c:1646  */
+#line 1657 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 11:
@@ -1654,9 +1661,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-8]);
       SET_NODELOC((yylsp[-8]));
-      (yyval.feature) = method((yyvsp[-8].symbol), (yyvsp[-6].formals), (yyvsp[-3].symbol), (yyvsp[-1].expression));
+      (yyval.feature) = method(id_symbol((yyvsp[-8].span)), (yyvsp[-6].formals), id_symbol((yyvsp[-3].span)), (yyvsp[-1].expression));
     }
-#line 1660 "cool.tab.c" /* yacc.c:1646  */
+#line 1667 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 12:
@@ -1664,9 +1671,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-2]);
       SET_NODELOC((yylsp[-2]));
-      (yyval.feature) = attr((yyvsp[-2].symbol), (yyvsp[0].symbol), no_expr());
+      (yyval.feature) = attr(id_symbol((yyvsp[-2].span)), id_symbol((yyvsp[0].span)), no_expr());
     }
-#line 1670 "cool.tab.c" /* yacc.c:1646  */
+#line 1677 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 13:
@@ -1674,9 +1681,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-4]);
       SET_NODELOC((yylsp[-4]));
-      (yyval.feature) = attr((yyvsp[-4].symbol), (yyvsp[-2].symbol), (yyvsp[0].expression));
+      (yyval.feature) = attr(id_symbol((yyvsp[-4].span)), id_symbol((yyvsp[-2].span)), (yyvsp[0].expression));
     }
-#line 1680 "cool.tab.c" /* yacc.c:1646  */
+#line 1687 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 14:
@@ -1684,7 +1691,7 @@ yyreduce:
     { (yyloc) = (yylsp[0]);
       SET_NODELOC((yylsp[0]));
     }
-#line 1688 "cool.tab.c" /* yacc.c:1646  */
+#line 1695 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 15:
@@ -1692,7 +1699,7 @@ yyreduce:
     {
       (yyval.formals) = nil_Formals();
     }
-#line 1696 "cool.tab.c" /* yacc.c:1646  */
+#line 1703 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 16:
@@ -1702,7 +1709,7 @@ yyreduce:
       SET_NODELOC((yylsp[0]));
       (yyval.formals) = single_Formals((yyvsp[0].formal));
     }
-#line 1706 "cool.tab.c" /* yacc.c:1646  */
+#line 1713 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 17:
@@ -1712,7 +1719,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.formals) = append_Formals((yyvsp[-2].formals), single_Formals((yyvsp[0].formal)));
     }
-#line 1716 "cool.tab.c" /* yacc.c:1646  */
+#line 1723 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 18:
@@ -1720,9 +1727,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-2]);
       SET_NODELOC((yylsp[-2]));
-      (yyval.formal) = formal((yyvsp[-2].symbol), (yyvsp[0].symbol));
+      (yyval.formal) = formal(id_symbol((yyvsp[-2].span)), id_symbol((yyvsp[0].span)));
     }
-#line 1726 "cool.tab.c" /* yacc.c:1646  */
+#line 1733 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 19:
@@ -1730,9 +1737,9 @@ yyreduce:
     { 
       (yyloc) = (yylsp[-2]);
       SET_NODELOC((yylsp[-2]));
-      (yyval.expression) = assign((yyvsp[-2].symbol), (yyvsp[0].expression));
+      (yyval.expression) = assign(id_symbol((yyvsp[-2].span)), (yyvsp[0].expression));
     }
-#line 1736 "cool.tab.c" /* yacc.c:1646  */
+#line 1743 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 20:
@@ -1740,9 +1747,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-7]);
       SET_NODELOC((yylsp[-7]));
-      (yyval.expression) = static_dispatch((yyvsp[-7].expression), (yyvsp[-5].symbol), (yyvsp[-3].symbol), (yyvsp[-1].expressions));
+      (yyval.expression) = static_dispatch((yyvsp[-7].expression), id_symbol((yyvsp[-5].span)), id_symbol((yyvsp[-3].span)), (yyvsp[-1].expressions));
     }
-#line 1746 "cool.tab.c" /* yacc.c:1646  */
+#line 1753 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 21:
@@ -1750,9 +1757,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-5]);
       SET_NODELOC((yylsp[-5]));
-      (yyval.expression) = dispatch((yyvsp[-5].expression), (yyvsp[-3].symbol), (yyvsp[-1].expressions));
+      (yyval.expression) = dispatch((yyvsp[-5].expression), id_symbol((yyvsp[-3].span)), (yyvsp[-1].expressions));
     }
-#line 1756 "cool.tab.c" /* yacc.c:1646  */
+#line 1763 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 22:
@@ -1760,9 +1767,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-3]);
       SET_NODELOC((yylsp[-3]));
-      (yyval.expression) = dispatch(object(idtable.add_string("self")), (yyvsp[-3].symbol), (yyvsp[-1].expressions));
+      (yyval.expression) = dispatch(object(idtable.add_string("self")), id_symbol((yyvsp[-3].span)), (yyvsp[-1].expressions));
     }
-#line 1766 "cool.tab.c" /* yacc.c:1646  */
+#line 1773 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 23:
@@ -1772,7 +1779,7 @@ yyreduce:
       SET_NODELOC((yylsp[-6]));
       (yyval.expression) = cond((yyvsp[-5].expression), (yyvsp[-3].expression), (yyvsp[-1].expression));
     }
-#line 1776 "cool.tab.c" /* yacc.c:1646  */
+#line 1783 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 24:
@@ -1782,7 +1789,7 @@ yyreduce:
       SET_NODELOC((yylsp[-4]));
       (yyval.expression) = loop((yyvsp[-3].expression), (yyvsp[-1].expression));
     }
-#line 1786 "cool.tab.c" /* yacc.c:1646  */
+#line 1793 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 25:
@@ -1792,7 +1799,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = block((yyvsp[-1].expressions));
     }
-#line 1796 "cool.tab.c" /* yacc.c:1646  */
+#line 1803 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 26:
@@ -1802,7 +1809,7 @@ yyreduce:
       SET_NODELOC((yylsp[-1]));
       (yyval.expression) = (yyvsp[0].expression);
     }
-#line 1806 "cool.tab.c" /* yacc.c:1646  */
+#line 1813 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 27:
@@ -1812,7 +1819,7 @@ yyreduce:
       SET_NODELOC((yylsp[-4]));
       (yyval.expression) = typcase((yyvsp[-3].expression), (yyvsp[-1].cases));
     }
-#line 1816 "cool.tab.c" /* yacc.c:1646  */
+#line 1823 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 28:
@@ -1820,9 +1827,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-1]);
       SET_NODELOC((yylsp[-1]));
-      (yyval.expression) = new_((yyvsp[0].symbol));
+      (yyval.expression) = new_(id_symbol((yyvsp[0].span)));
     }
-#line 1826 "cool.tab.c" /* yacc.c:1646  */
+#line 1833 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 29:
@@ -1832,7 +1839,7 @@ yyreduce:
       SET_NODELOC((yylsp[-1]));
       (yyval.expression) = isvoid((yyvsp[0].expression));
     }
-#line 1836 "cool.tab.c" /* yacc.c:1646  */
+#line 1843 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 30:
@@ -1842,7 +1849,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = plus((yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 1846 "cool.tab.c" /* yacc.c:1646  */
+#line 1853 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 31:
@@ -1852,7 +1859,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = sub((yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 1856 "cool.tab.c" /* yacc.c:1646  */
+#line 1863 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 32:
@@ -1862,7 +1869,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = mul((yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 1866 "cool.tab.c" /* yacc.c:1646  */
+#line 1873 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 33:
@@ -1872,7 +1879,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = divide((yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 1876 "cool.tab.c" /* yacc.c:1646  */
+#line 1883 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 34:
@@ -1882,7 +1889,7 @@ yyreduce:
       SET_NODELOC((yylsp[-1]));
       (yyval.expression) = neg((yyvsp[0].expression));
     }
-#line 1886 "cool.tab.c" /* yacc.c:1646  */
+#line 1893 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 35:
@@ -1892,7 +1899,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = lt((yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 1896 "cool.tab.c" /* yacc.c:1646  */
+#line 1903 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 36:
@@ -1902,7 +1909,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = leq((yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 1906 "cool.tab.c" /* yacc.c:1646  */
+#line 1913 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 37:
@@ -1912,7 +1919,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = eq((yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 1916 "cool.tab.c" /* yacc.c:1646  */
+#line 1923 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 38:
@@ -1922,7 +1929,7 @@ yyreduce:
       SET_NODELOC((yylsp[-1]));
       (yyval.expression) = comp((yyvsp[0].expression));
     }
-#line 1926 "cool.tab.c" /* yacc.c:1646  */
+#line 1933 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 39:
@@ -1932,7 +1939,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expression) = (yyvsp[-1].expression);
     }
-#line 1936 "cool.tab.c" /* yacc.c:1646  */
+#line 1943 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 40:
@@ -1940,9 +1947,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[0]);
       SET_NODELOC((yylsp[0]));
-      (yyval.expression) = object((yyvsp[0].symbol));
+      (yyval.expression) = object(id_symbol((yyvsp[0].span)));
     }
-#line 1946 "cool.tab.c" /* yacc.c:1646  */
+#line 1953 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 41:
@@ -1950,9 +1957,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[0]);
       SET_NODELOC((yylsp[0]));
-      (yyval.expression) = int_const((yyvsp[0].symbol));
+      (yyval.expression) = int_const(int_symbol((yyvsp[0].span)));
     }
-#line 1956 "cool.tab.c" /* yacc.c:1646  */
+#line 1963 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 42:
@@ -1960,9 +1967,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[0]);
       SET_NODELOC((yylsp[0]));
-      (yyval.expression) = string_const((yyvsp[0].symbol));
+      (yyval.expression) = string_const(string_symbol((yyvsp[0].span)));
     }
-#line 1966 "cool.tab.c" /* yacc.c:1646  */
+#line 1973 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 43:
@@ -1972,7 +1979,7 @@ yyreduce:
       SET_NODELOC((yylsp[0]));
       (yyval.expression) = bool_const((yyvsp[0].boolean));
     }
-#line 1976 "cool.tab.c" /* yacc.c:1646  */
+#line 1983 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 44:
@@ -1980,7 +1987,7 @@ yyreduce:
     {
       (yyval.expressions) = nil_Expressions();
     }
-#line 1984 "cool.tab.c" /* yacc.c:1646  */
+#line 1991 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 45:
@@ -1990,7 +1997,7 @@ yyreduce:
       SET_NODELOC((yylsp[0]));
       (yyval.expressions) = single_Expressions((yyvsp[0].expression));
     }
-#line 1994 "cool.tab.c" /* yacc.c:1646  */
+#line 2001 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 46:
@@ -2000,7 +2007,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expressions) = append_Expressions((yyvsp[-2].expressions), single_Expressions((yyvsp[0].expression)));
     }
-#line 2004 "cool.tab.c" /* yacc.c:1646  */
+#line 2011 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 47:
@@ -2010,7 +2017,7 @@ yyreduce:
       SET_NODELOC((yylsp[-1]));
       (yyval.expressions) = single_Expressions((yyvsp[-1].expression));
     }
-#line 2014 "cool.tab.c" /* yacc.c:1646  */
+#line 2021 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 48:
@@ -2020,7 +2027,7 @@ yyreduce:
       SET_NODELOC((yylsp[-2]));
       (yyval.expressions) = append_Expressions((yyvsp[-2].expressions), single_Expressions((yyvsp[-1].expression)));
     }
-#line 2024 "cool.tab.c" /* yacc.c:1646  */
+#line 2031 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 49:
@@ -2028,9 +2035,10 @@ yyreduce:
     {
       (yyloc) = (yylsp[-1]);
       SET_NODELOC((yylsp[-1]));
+      (yyval.expressions) = nil_Expressions();
       yyerrok;
     }
-#line 2034 "cool.tab.c" /* yacc.c:1646  */
+#line 2042 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 50:
@@ -2038,9 +2046,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-4]);
       SET_NODELOC((yylsp[-4]));
-      (yyval.expression) = let((yyvsp[-4].symbol), (yyvsp[-2].symbol), no_expr(), (yyvsp[0].expression));
+      (yyval.expression) = let(id_symbol((yyvsp[-4].span)), id_symbol((yyvsp[-2].span)), no_expr(), (yyvsp[0].expression));
     }
-#line 2044 "cool.tab.c" /* yacc.c:1646  */
+#line 2052 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 51:
@@ -2048,9 +2056,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-6]);
       SET_NODELOC((yylsp[-6]));
-      (yyval.expression) = let((yyvsp[-6].symbol), (yyvsp[-4].symbol), (yyvsp[-2].expression), (yyvsp[0].expression));
+      (yyval.expression) = let(id_symbol((yyvsp[-6].span)), id_symbol((yyvsp[-4].span)), (yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 2054 "cool.tab.c" /* yacc.c:1646  */
+#line 2062 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 52:
@@ -2058,9 +2066,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-4]);
       SET_NODELOC((yylsp[-4]));
-      (yyval.expression) = let((yyvsp[-4].symbol), (yyvsp[-2].symbol), no_expr(), (yyvsp[0].expression));
+      (yyval.expression) = let(id_symbol((yyvsp[-4].span)), id_symbol((yyvsp[-2].span)), no_expr(), (yyvsp[0].expression));
     }
-#line 2064 "cool.tab.c" /* yacc.c:1646  */
+#line 2072 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 53:
@@ -2068,9 +2076,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-6]);
       SET_NODELOC((yylsp[-6]));
-      (yyval.expression) = let((yyvsp[-6].symbol), (yyvsp[-4].symbol), (yyvsp[-2].expression), (yyvsp[0].expression));
+      (yyval.expression) = let(id_symbol((yyvsp[-6].span)), id_symbol((yyvsp[-4].span)), (yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 2074 "cool.tab.c" /* yacc.c:1646  */
+#line 2082 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 54:
@@ -2079,7 +2087,7 @@ yyreduce:
       (yyloc) = (yylsp[-2]);
       SET_NODELOC((yylsp[-2]));
     }
-#line 2083 "cool.tab.c" /* yacc.c:1646  */
+#line 2091 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 55:
@@ -2087,9 +2095,9 @@ yyreduce:
     {
       (yyloc) = (yylsp[-5]);
       SET_NODELOC((yylsp[-5]));
-      (yyval.cases) = single_Cases(branch((yyvsp[-5].symbol), (yyvsp[-3].symbol), (yyvsp[-1].expression)));
+      (yyval.cases) = single_Cases(branch(id_symbol((yyvsp[-5].span)), id_symbol((yyvsp[-3].span)), (yyvsp[-1].expression)));
     }
-#line 2093 "cool.tab.c" /* yacc.c:1646  */
+#line 2101 "cool.tab.c" /* yacc.c:1646  */
     break;
 
   case 56:
@@ -2097,13 +2105,13 @@ yyreduce:
     {
       (yyloc) = (yylsp[-6]);
       SET_NODELOC((yylsp[-6]));
-      (yyval.cases) = append_Cases((yyvsp[-6].cases), single_Cases(branch((yyvsp[-5].symbol), (yyvsp[-3].symbol), (yyvsp[-1].expression))));
+      (yyval.cases) = append_Cases((yyvsp[-6].cases), single_Cases(branch(id_symbol((yyvsp[-5].span)), id_symbol((yyvsp[-3].span)), (yyvsp[-1].expression))));
     }
-#line 2103 "cool.tab.c" /* yacc.c:1646  */
+#line 2111 "cool.tab.c" /* yacc.c:1646  */
     break;
 
 
-#line 2107 "cool.tab.c" /* yacc.c:1646  */
+#line 2115 "cool.tab.c" /* yacc.c:1646  */
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
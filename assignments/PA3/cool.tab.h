@@ -109,7 +109,7 @@ union YYSTYPE
 #line 89 "cool.y" /* yacc.c:1909  */
 
       Boolean boolean;
-      Symbol symbol;
+      Span span;
       Program program;
       Class_ class_;
       Classes classes;
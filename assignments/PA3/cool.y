@@ -9,15 +9,40 @@
   #include "stringtab.h"
   #include "utilities.h"
   
-  extern char *curr_filename;
+  extern __thread char *curr_filename;
+  
+  /* TYPEID, OBJECTID, INT_CONST and STR_CONST tokens carry the span of
+  their text in the lexer's input, which is interned only here, when a
+  node is built from the token.  When several files are parsed at once,
+  on threads of their own (coolc -j), each thread enters its strings
+  through symbol_caches, caches of its own in front of the tables (see
+  StringTableCache in stringtab.h). */
+  __thread SymbolCaches *symbol_caches;
+  
+  static Symbol id_symbol(Span s)
+  {
+    return symbol_caches ? symbol_caches->ids.add_chars(s.text, s.len)
+                         : idtable.add_chars(s.text, s.len);
+  }
+  static Symbol int_symbol(Span s)
+  {
+    return symbol_caches ? symbol_caches->ints.add_chars(s.text, s.len)
+                         : inttable.add_chars(s.text, s.len);
+  }
+  static Symbol string_symbol(Span s)
+  {
+    return symbol_caches ? symbol_caches->strings.add_chars(s.text, s.len)
+                         : stringtable.add_chars(s.text, s.len);
+  }
+  static Symbol id_symbol(char *s)     { Span sp = { s, (int) strlen(s) }; return id_symbol(sp); }
+  static Symbol string_symbol(char *s) { Span sp = { s, (int) strlen(s) }; return string_symbol(sp); }
   
   
   /* Locations */
-  #define YYLTYPE int              /* the type of locations */
-  #define cool_yylloc curr_lineno  /* use the curr_lineno from the lexer
-  for the location of tokens */
+  #define YYLTYPE int              /* the type of locations: the line of
+  the token, from curr_lineno */
     
-    extern int node_lineno;          /* set before constructing a tree node
+    extern __thread int node_lineno;          /* set before constructing a tree node
     to whatever you want the line number
     for the tree node to be */
       
@@ -74,21 +99,25 @@
     
     
     
-    void yyerror(char *s);        /*  defined below; called for each parse error */
-    extern int yylex();           /*  the entry point to the lexer  */
+    void yyerror(YYLTYPE *loc, char *s);  /*  defined below; called for each parse error */
+    extern int cool_yylex();      /*  the entry point to the lexer  */
+    #undef yylex                  /*  ... which yylex, below, calls */
     
     /************************************************************************/
     /*                DONT CHANGE ANYTHING IN THIS SECTION                  */
     
-    Program ast_root;	      /* the result of the parse  */
-    Classes parse_results;        /* for use in semantic analysis */
-    int omerrs = 0;               /* number of errors in lexing and parsing */
+    /* The state of a parse is kept one per thread, so that several
+    threads can parse at once; see coolc.cc. */
+    __thread Program ast_root;	      /* the result of the parse  */
+    __thread Classes parse_results;        /* for use in semantic analysis */
+    __thread int omerrs = 0;               /* number of errors in lexing and parsing */
+    __thread ostream *parse_errors = &cerr;   /* where yyerror reports them */
     %}
     
     /* A union of all the types that can be the result of parsing actions. */
     %union {
       Boolean boolean;
-      Symbol symbol;
+      Span span;
       Program program;
       Class_ class_;
       Classes classes;
@@ -103,6 +132,26 @@
       char *error_msg;
     }
     
+    %{
+    /* The parser is pure: the lookahead token is kept in variables of
+    cool_yyparse, not in globals.  The lexer hands each token on in
+    cool_yylval and curr_lineno, of which there is one per thread, and
+    yylex passes it on to the parser, keeping the token for yyerror. */
+    __thread YYSTYPE cool_yylval;
+    __thread int curr_lineno = 1;
+    static __thread int lookahead;
+    
+    static int yylex(YYSTYPE *lval, YYLTYPE *lloc)
+    {
+      lookahead = cool_yylex();
+      *lval = cool_yylval;
+      *lloc = curr_lineno;
+      return lookahead;
+    }
+    %}
+    
+    %define api.pure full
+    
     /* 
     Declare the terminals; a few have types for associated lexemes.
     The token ERROR is never used in the parser; thus, it is a parse
@@ -117,9 +166,9 @@
     %token CLASS 258 ELSE 259 FI 260 IF 261 IN 262 
     %token INHERITS 263 LET 264 LOOP 265 POOL 266 THEN 267 WHILE 268
     %token CASE 269 ESAC 270 OF 271 DARROW 272 NEW 273 ISVOID 274
-    %token <symbol>  STR_CONST 275 INT_CONST 276 
+    %token <span>    STR_CONST 275 INT_CONST 276 
     %token <boolean> BOOL_CONST 277
-    %token <symbol>  TYPEID 278 OBJECTID 279 
+    %token <span>    TYPEID 278 OBJECTID 279 
     %token ASSIGN 280 NOT 281 LE 282 ERROR 283
     
     /*  DON'T CHANGE ANYTHING ABOVE THIS LINE, OR YOUR PARSER WONT WORK       */
@@ -175,9 +224,9 @@
     /* If no parent is specified, the class inherits from the Object class. */
     class	
     : CLASS TYPEID '{' dummy_feature_list '}' ';'
-    { $$ = class_($2,idtable.add_string("Object"), $4, stringtable.add_string(curr_filename)); }
+    { $$ = class_(id_symbol($2),id_symbol("Object"), $4, string_symbol(curr_filename)); }
     | CLASS TYPEID INHERITS TYPEID '{' dummy_feature_list '}' ';'
-    { $$ = class_($2,$4,$6,stringtable.add_string(curr_filename)); }
+    { $$ = class_(id_symbol($2),id_symbol($4),$6,string_symbol(curr_filename)); }
     ;
     
     /* Feature list may be empty, but no empty features in list. */
@@ -190,31 +239,31 @@
 
     feature
     : OBJECTID '(' formal_list ')' ':' TYPEID '{' expre '}' ';'
-    { $$ = method($1, $3, $6, $8);}
+    { $$ = method(id_symbol($1), $3, id_symbol($6), $8);}
     | OBJECTID ':' TYPEID ';'
-    { $$ = attr($1, $3, no_expr());}
+    { $$ = attr(id_symbol($1), id_symbol($3), no_expr());}
     | OBJECTID ':' TYPEID ASSIGN expre ';'
-    { $$ = attr($1, $3, $5);}
+    { $$ = attr(id_symbol($1), id_symbol($3), $5);}
     ;
     
     expre 
     : OBJECTID ASSIGN expre
-    { $$ = assign($1, $3);}
+    { $$ = assign(id_symbol($1), $3);}
     /* static type dispatch */
     | expre '@' TYPEID '.' OBJECTID '(' ')'
-    { $$ = static_dispatch($1, $3, $5, nil_Expressions());}
+    { $$ = static_dispatch($1, id_symbol($3), id_symbol($5), nil_Expressions());}
     | expre '@' TYPEID '.' OBJECTID '(' dispatch_expre ')'
-    { $$ = static_dispatch($1, $3, $5, $7);}
+    { $$ = static_dispatch($1, id_symbol($3), id_symbol($5), $7);}
     /* dispatch (commonly used form) */
     | expre '.' OBJECTID '(' ')'
-    { $$ = dispatch($1, $3, nil_Expressions());}
+    { $$ = dispatch($1, id_symbol($3), nil_Expressions());}
     | expre '.' OBJECTID '(' dispatch_expre ')'
-    { $$ = dispatch($1, $3, $5);}
+    { $$ = dispatch($1, id_symbol($3), $5);}
     /* self type dispatch */
     | OBJECTID '(' ')'
-    { $$ = dispatch(object(idtable.add_string("self")), $1, nil_Expressions());}
+    { $$ = dispatch(object(id_symbol("self")), id_symbol($1), nil_Expressions());}
     | OBJECTID '(' dispatch_expre ')'
-    { $$ = dispatch(object(idtable.add_string("self")), $1, $3);}
+    { $$ = dispatch(object(id_symbol("self")), id_symbol($1), $3);}
     /* if-else */
     | IF expre THEN expre ELSE expre FI
     { $$ = cond($2, $4, $6);}
@@ -234,7 +283,7 @@
     { $$ = typcase($2, $4);}
     /* new */
     | NEW TYPEID
-    { $$ = new_($2);}
+    { $$ = new_(id_symbol($2));}
     /* is void*/
     | ISVOID expre
     { $$ = isvoid($2);}
@@ -270,13 +319,13 @@
     { $$ = $2;}
     /* objectid */
     | OBJECTID
-    { $$ = object($1);}
+    { $$ = object(id_symbol($1));}
     /* typeid */
     | INT_CONST
-    { $$ = int_const($1);}
+    { $$ = int_const(int_symbol($1));}
     /* string */
     | STR_CONST
-    { $$ = string_const($1);}
+    { $$ = string_const(string_symbol($1));}
     /* boolean */
     | BOOL_CONST
     { $$ = bool_const($1);}
@@ -291,7 +340,7 @@
 
     formal
     : OBJECTID ':' TYPEID
-    { $$ = formal($1, $3);}
+    { $$ = formal(id_symbol($1), id_symbol($3));}
     ;
 
     formal_list
@@ -312,18 +361,18 @@
 
     let_expre
     : OBJECTID ':' TYPEID IN expre %prec FLAG
-    { $$ = let($1, $3, no_expr(), $5);}
+    { $$ = let(id_symbol($1), id_symbol($3), no_expr(), $5);}
     | OBJECTID ':' TYPEID ASSIGN expre IN expre %prec FLAG
-    { $$ = let($1, $3, $5, $7);}
+    { $$ = let(id_symbol($1), id_symbol($3), $5, $7);}
     | OBJECTID ':' TYPEID ',' let_expre 
-    { $$ = let($1, $3, no_expr(), $5); }
+    { $$ = let(id_symbol($1), id_symbol($3), no_expr(), $5); }
     | OBJECTID ':' TYPEID ASSIGN expre ',' let_expre 
-    { $$ = let($1, $3, $5, $7); }
+    { $$ = let(id_symbol($1), id_symbol($3), $5, $7); }
     ;
 
     case
     : OBJECTID ':' TYPEID DARROW expre ';'
-    { $$ = branch($1, $3, $5);}
+    { $$ = branch(id_symbol($1), id_symbol($3), $5);}
     ;
 
     case_list
@@ -337,17 +386,19 @@
     %%
     
     /* This function is called automatically when Bison detects a parse error. */
-    void yyerror(char *s)
+    void yyerror(YYLTYPE *loc, char *s)
     {
-      extern int curr_lineno;
+      ostream &err = *parse_errors;
       
-      cerr << "\"" << curr_filename << "\", line " << curr_lineno << ": " \
+      err << "\"" << curr_filename << "\", line " << *loc << ": " \
       << s << " at or near ";
-      print_cool_token(yychar);
-      cerr << endl;
+      print_cool_token(err, lookahead);
+      err << endl;
       omerrs++;
       
-      if(omerrs>50) {fprintf(stdout, "More than 50 errors\n"); exit(1);}
+      /* A parse whose errors are kept for later goes on; whoever prints
+      them stops after 50 (see coolc.cc). */
+      if(omerrs>50 && parse_errors == &cerr) {fprintf(stdout, "More than 50 errors\n"); exit(1);}
     }
     
     
\ No newline at end of file
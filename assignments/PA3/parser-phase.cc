@@ -16,6 +16,7 @@
 #include <unistd.h>    // for getopt
 #include "cool-io.h"  //includes iostream
 #include "cool-tree.h"
+#include "compact-ast.h"
 #include "utilities.h"  // for fatal_error
 #include "cool-parse.h"
 
@@ -23,12 +24,13 @@
 // These globals keep everything working.
 //
 FILE *token_file = stdin;		// we read from this file
-extern Classes parse_results;	 // list of classes; used for multiple files 
-extern Program ast_root;	 // the AST produced by the parse
+extern __thread Classes parse_results;	 // list of classes; used for multiple files 
+extern __thread Program ast_root;	 // the AST produced by the parse
 
-char *curr_filename = "<stdin>";
+__thread char *curr_filename = "<stdin>";
 
-extern int omerrs;             // a count of lex and parse errors
+extern __thread int omerrs;            // a count of lex and parse errors
+extern int binary_ast;         // write the AST in binary form
 
 extern int cool_yyparse();
 void handle_flags(int argc, char *argv[]);
@@ -40,7 +42,11 @@ int main(int argc, char *argv[]) {
 	cerr << "Compilation halted due to lex and parse errors\n";
 	exit(1);
     }
-    ast_root->dump_with_types(cout,0);
+    if (binary_ast)
+	ast_root->dump_binary(cout);
+    else
+	ast_root->dump_with_types(cout,0);
+    release_tree_nodes();
     return 0;
 }
 
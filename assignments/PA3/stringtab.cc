@@ -17,11 +17,20 @@ extern char *pad(int n);
 template class StringTable<IdEntry>;
 template class StringTable<StringEntry>;
 template class StringTable<IntEntry>;
+template class StringTableCache<IdEntry>;
+template class StringTableCache<StringEntry>;
+template class StringTableCache<IntEntry>;
 
 Entry::Entry(char *s, int l, int i) : len(l), index(i) {
   str = new char [len+1];
   strncpy(str, s, len);
   str[len] = '\0';
+  hash = string_hash(str, len);
+}
+
+Entry::Entry(char *s, int l, int i, Arena& pool) : len(l), index(i) {
+  str = pool.copy_string(s, len);
+  hash = string_hash(str, len);
 }
 
 int Entry::equal_string(char *string, int length) const
@@ -74,6 +83,10 @@ StringEntry::StringEntry(char *s, int l, int i) : Entry(s,l,i) { }
 IdEntry::IdEntry(char *s, int l, int i) : Entry(s,l,i) { }
 IntEntry::IntEntry(char *s, int l, int i) : Entry(s,l,i) { }
 
+StringEntry::StringEntry(char *s, int l, int i, Arena& pool) : Entry(s,l,i,pool) { }
+IdEntry::IdEntry(char *s, int l, int i, Arena& pool) : Entry(s,l,i,pool) { }
+IntEntry::IntEntry(char *s, int l, int i, Arena& pool) : Entry(s,l,i,pool) { }
+
 IdTable idtable;
 IntTable inttable;
 StrTable stringtable;
@@ -16,7 +16,37 @@
 #include "tree.h"
 
 /* line number to assign to the current node being constructed */
-int node_lineno = 1;
+__thread int node_lineno = 1;
+
+/* storage for all tree nodes and AST list elements */
+Arena node_arena;
+
+/* the arena that this thread allocates nodes from */
+__thread Arena *node_pool = &node_arena;
+
+///////////////////////////////////////////////////////////////////////////
+//
+// tree_node::operator new
+//
+// allocate a tree node from the node arena
+//
+///////////////////////////////////////////////////////////////////////////
+void *tree_node::operator new(size_t size)
+{
+    return node_pool->allocate(size, alignof(double));
+}
+
+///////////////////////////////////////////////////////////////////////////
+//
+// release_tree_nodes
+//
+// free every tree node at once
+//
+///////////////////////////////////////////////////////////////////////////
+void release_tree_nodes()
+{
+    node_arena.clear();
+}
 
 ///////////////////////////////////////////////////////////////////////////
 //
@@ -47,3 +77,119 @@ tree_node *tree_node::set(tree_node *t) {
    line_number = t->line_number;
    return this;
 }
+
+///////////////////////////////////////////////////////////////////////////
+//
+// tree_walker::walk
+//
+// walk the tree t (see tree.h).  The frame of a node is pushed on
+// entering it and popped after its post hook; the stack grows by
+// doubling.
+//
+///////////////////////////////////////////////////////////////////////////
+void tree_walker::enter(tree_node *t, int n)
+{
+    if (depth == size) {
+	int new_size = size ? 2 * size : 64;
+	frame *s = new frame[new_size];
+	for (int i = 0; i < depth; i++)
+	    s[i] = stack[i];
+	delete [] stack;
+	stack = s;
+	size = new_size;
+    }
+    skip = false;
+    int kid_n = pre(t, n);
+    frame &f = stack[depth++];
+    f.node = t;
+    f.n = n;
+    f.kid_n = kid_n;
+    f.next = 0;
+    f.nkids = skip ? 0 : t->children();
+}
+
+void tree_walker::walk(tree_node *t, int n)
+{
+    int base = depth;
+
+    enter(t, n);
+    while (depth > base) {
+	frame &f = stack[depth - 1];
+	if (f.next < f.nkids) {
+	    int i = f.next++;
+	    if (i > 0)
+		in(f.node, f.n, i);
+	    enter(f.node->child(i), f.kid_n);
+	} else {
+	    post(f.node, f.n);
+	    depth--;
+	}
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////
+//
+// tree_node::dump
+//
+// print the tree through the dump hooks of its nodes
+//
+///////////////////////////////////////////////////////////////////////////
+class dump_walker : public tree_walker {
+    ostream& stream;
+public:
+    dump_walker(ostream& s) : stream(s) { }
+    int pre(tree_node *t, int n)          { return t->dump_pre(stream, n); }
+    void in(tree_node *t, int n, int i)   { t->dump_in(stream, n, i); }
+    void post(tree_node *t, int n)        { t->dump_post(stream, n); }
+};
+
+void tree_node::dump(ostream& stream, int n)
+{
+    dump_walker w(stream);
+    w.walk(this, n);
+}
+
+///////////////////////////////////////////////////////////////////////////
+//
+// tree_node::copy
+//
+// return a deep copy of the tree.  The copies of the subtrees of the
+// nodes being walked are kept on a stack; a node's post hook replaces
+// those of its subtrees with its own.
+//
+///////////////////////////////////////////////////////////////////////////
+class copy_walker : public tree_walker {
+    tree_node **copies;
+    int ncopies;
+    int size;
+public:
+    copy_walker() : copies(NULL), ncopies(0), size(0) { }
+    ~copy_walker()                        { delete [] copies; }
+    void post(tree_node *t, int n);
+    tree_node *result()                   { return copies[0]; }
+};
+
+void copy_walker::post(tree_node *t, int n)
+{
+    int nkids = t->children();
+    tree_node *c = t->copy_node(copies + ncopies - nkids);
+
+    ncopies -= nkids;
+    if (ncopies == size) {
+	int new_size = size ? 2 * size : 64;
+	tree_node **s = new tree_node *[new_size];
+	for (int i = 0; i < ncopies; i++)
+	    s[i] = copies[i];
+	delete [] copies;
+	copies = s;
+	size = new_size;
+    }
+    copies[ncopies++] = c;
+}
+
+tree_node *tree_node::copy()
+{
+    copy_walker w;
+    w.walk(this, 0);
+    return w.result();
+}
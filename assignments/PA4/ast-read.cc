@@ -0,0 +1,670 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// file: ast-read.cc
+//
+// A hand-written reader for the textual AST format produced by
+// dump_with_types.  It replaces the flex/bison reader of ast-lex.cc and
+// ast-parse.cc (ast_yyparse): it accepts the same input and builds the
+// same tree, entering the same symbols into idtable, inttable and
+// stringtable in the same order, but it is much faster: the whole input
+// is read into one buffer, and tokens are recognized and interned in
+// place.
+//
+// The format is line oriented but the reader, like ast_yyparse, only
+// cares about the sequence of tokens:
+//
+//    #n          the line number of the node that follows
+//    _keyword    the kind of a node (_program, _class, _plus, ...)
+//    name        an identifier or type name, entered into idtable
+//    123         an integer constant, entered into inttable
+//    "..."       a string constant, entered into stringtable
+//    ( ) :       punctuation
+//
+// Each node is its line number, its keyword and its components in the
+// order of dump_with_types; an expression ends with ": type", where the
+// type _no_type stands for no type at all.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "cool-tree.h"
+#include "compact-ast.h"   // for AstKind
+
+extern __thread int node_lineno;
+
+#define MAX_STR_CONST 1025   // longest string constant, as in ast-lex
+
+//
+// The node keywords and the kinds of node they introduce.
+//
+static struct {
+  const char *name;
+  int len;
+  AstKind kind;
+} keywords[] = {
+  { "_program", 8, AST_PROGRAM },
+  { "_class", 6, AST_CLASS },
+  { "_method", 7, AST_METHOD },
+  { "_attr", 5, AST_ATTR },
+  { "_formal", 7, AST_FORMAL },
+  { "_branch", 7, AST_BRANCH },
+  { "_assign", 7, AST_ASSIGN },
+  { "_static_dispatch", 16, AST_STATIC_DISPATCH },
+  { "_dispatch", 9, AST_DISPATCH },
+  { "_cond", 5, AST_COND },
+  { "_loop", 5, AST_LOOP },
+  { "_typcase", 8, AST_TYPCASE },
+  { "_block", 6, AST_BLOCK },
+  { "_let", 4, AST_LET },
+  { "_plus", 5, AST_PLUS },
+  { "_sub", 4, AST_SUB },
+  { "_mul", 4, AST_MUL },
+  { "_divide", 7, AST_DIVIDE },
+  { "_neg", 4, AST_NEG },
+  { "_lt", 3, AST_LT },
+  { "_eq", 3, AST_EQ },
+  { "_leq", 4, AST_LEQ },
+  { "_comp", 5, AST_COMP },
+  { "_int", 4, AST_INT_CONST },
+  { "_bool", 5, AST_BOOL_CONST },
+  { "_string", 7, AST_STRING_CONST },
+  { "_new", 4, AST_NEW },
+  { "_isvoid", 7, AST_ISVOID },
+  { "_no_expr", 8, AST_NO_EXPR },
+  { "_object", 7, AST_OBJECT },
+  { NULL, 0, AST_LIST }
+};
+
+static bool is_word_char(char c)
+{
+  return isalnum((unsigned char) c) || c == '_';
+}
+
+static bool is_octal_digit(char c)
+{
+  return c >= '0' && c <= '7';
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+//  AstReader
+//
+//  A recursive descent parser over a null terminated buffer holding the
+//  whole input.  There is one method per nonterminal; each one reads
+//  the components of its node into locals before calling the
+//  constructor, so that node_lineno is set just before the node is
+//  built, as in ast-parse.
+//
+//  Expressions, which may nest as deeply as the program does, are read
+//  without recursion: each expression being read has an ExprFrame on a
+//  stack, holding the components read so far, and a subexpression is
+//  read by pushing a frame for it.
+//
+/////////////////////////////////////////////////////////////////////////
+
+struct ExprFrame {
+  int line;
+  AstKind kind;
+  int nexprs;            // the subexpressions read so far
+  Symbol s1, s2;
+  Expression e[3];
+  Expressions list;      // the body of a block, or the actuals of a dispatch
+  Cases cases;
+  int branch_line;       // the branch of a case whose expression is read
+  Symbol branch_name, branch_type;
+};
+
+class AstReader {
+private:
+  char *buf;         // the input, followed by a null
+  char *p;           // the next character to read
+  ExprFrame *frames; // the expressions being read
+  int nframes;
+  int frames_size;
+
+  void syntax_error();
+
+  // The next character that is not white space.
+  char peek()
+  {
+    while (*p == ' ' || *p == '\n' || *p == '\t' || *p == '\r' ||
+	   *p == '\f' || *p == '\v')
+      p++;
+    return *p;
+  }
+
+  void expect(char c)
+  {
+    if (peek() != c)
+      syntax_error();
+    p++;
+  }
+
+  // Tokens.
+  char *word(int &len);
+  int lineno();
+  AstKind keyword();
+  Symbol id();
+  Symbol type();
+  Symbol int_const();
+  Symbol str_const();
+
+  // Nonterminals.
+  Class_ class_();
+  Feature feature();
+  Formal formal();
+  Expression expression();
+
+  // The steps of reading an expression.
+  void begin_expression();
+  bool more_expressions(ExprFrame *f);
+  void add_expression(ExprFrame *f, Expression e);
+  Expression end_expression(ExprFrame *f);
+
+public:
+  AstReader(char *b) : buf(b), p(b), frames(NULL), nframes(0), frames_size(0) { }
+  ~AstReader() { delete [] frames; }
+  Program program();
+};
+
+void AstReader::syntax_error()
+{
+  int line = 1;
+  for (char *q = buf; q < p; q++)
+    if (*q == '\n')
+      line++;
+  cerr << "Error in ast parsing (line " << line << "): syntax error" << endl;
+  exit(1);
+}
+
+//
+// A word is a run of letters, digits and underscores: a keyword, an
+// identifier or an integer.  word returns its start and length.
+//
+char *AstReader::word(int &len)
+{
+  peek();
+  char *start = p;
+  while (is_word_char(*p))
+    p++;
+  len = p - start;
+  if (len == 0)
+    syntax_error();
+  return start;
+}
+
+int AstReader::lineno()
+{
+  expect('#');
+  if (!isdigit((unsigned char) *p))
+    syntax_error();
+  return (int) strtol(p, &p, 10);
+}
+
+AstKind AstReader::keyword()
+{
+  int len;
+  char *w = word(len);
+  if (w[0] == '_')
+    for (int i = 0; keywords[i].name; i++)
+      if (keywords[i].len == len && memcmp(keywords[i].name, w, len) == 0)
+	return keywords[i].kind;
+  syntax_error();
+  return AST_LIST;
+}
+
+Symbol AstReader::id()
+{
+  int len;
+  char *w = word(len);
+  if (isdigit((unsigned char) w[0]))
+    syntax_error();
+  return idtable.add_chars(w, len);
+}
+
+// The type of an expression; _no_type is no type at all.
+Symbol AstReader::type()
+{
+  int len;
+  char *w = word(len);
+  if (len == 8 && memcmp(w, "_no_type", 8) == 0)
+    return NULL;
+  if (isdigit((unsigned char) w[0]))
+    syntax_error();
+  return idtable.add_chars(w, len);
+}
+
+Symbol AstReader::int_const()
+{
+  int len;
+  char *w = word(len);
+  for (int i = 0; i < len; i++)
+    if (!isdigit((unsigned char) w[i]))
+      syntax_error();
+  return inttable.add_chars(w, len);
+}
+
+//
+// A string constant with no escapes is interned straight from the
+// buffer.  Otherwise its escapes are expanded in place, which is safe
+// because an escape is never shorter than the character it stands for.
+// As in ast-lex, the string ends at the first null character and at
+// MAX_STR_CONST characters.
+//
+Symbol AstReader::str_const()
+{
+  expect('"');
+  char *start = p;
+  while (*p != '"' && *p != '\\' && *p != '\0')
+    p++;
+  if (*p == '"') {
+    int len = p - start;
+    p++;
+    return stringtable.add_chars(start, len < MAX_STR_CONST ? len : MAX_STR_CONST);
+  }
+
+  char *out = p;
+  while (*p != '"') {
+    if (*p == '\0')
+      syntax_error();
+    if (*p != '\\') {
+      *out++ = *p++;
+      continue;
+    }
+    p++;
+    switch (*p) {
+    case 'n': *out++ = '\n'; p++; break;
+    case 't': *out++ = '\t'; p++; break;
+    case 'b': *out++ = '\b'; p++; break;
+    case 'f': *out++ = '\f'; p++; break;
+    case '\0': syntax_error(); break;
+    default:
+      if (is_octal_digit(p[0]) && is_octal_digit(p[1]) && is_octal_digit(p[2])) {
+	// unprintable characters are written as three octal digits
+	*out++ = (char) ((p[0] - '0') * 64 + (p[1] - '0') * 8 + (p[2] - '0'));
+	p += 3;
+      } else
+	*out++ = *p++;
+    }
+  }
+  p++;
+  int len = out - start;
+  char *nul = (char *) memchr(start, '\0', len);
+  if (nul)
+    len = nul - start;
+  return stringtable.add_chars(start, len < MAX_STR_CONST ? len : MAX_STR_CONST);
+}
+
+Program AstReader::program()
+{
+  int line = lineno();
+  if (keyword() != AST_PROGRAM)
+    syntax_error();
+  Classes classes = single_Classes(class_());
+  while (peek() != '\0')
+    classes = append_Classes(classes, single_Classes(class_()));
+  node_lineno = line;
+  return ::program(classes);
+}
+
+Class_ AstReader::class_()
+{
+  int line = lineno();
+  if (keyword() != AST_CLASS)
+    syntax_error();
+  Symbol name = id();
+  Symbol parent = id();
+  Symbol filename = str_const();
+  expect('(');
+  Features features = nil_Features();
+  while (peek() == '#')
+    features = append_Features(features, single_Features(feature()));
+  expect(')');
+  node_lineno = line;
+  return ::class_(name, parent, features, filename);
+}
+
+Feature AstReader::feature()
+{
+  int line = lineno();
+  switch (keyword()) {
+  case AST_METHOD: {
+    Symbol name = id();
+    Formals formals = nil_Formals();
+    while (peek() == '#')
+      formals = append_Formals(formals, single_Formals(formal()));
+    Symbol return_type = id();
+    Expression expr = expression();
+    node_lineno = line;
+    return method(name, formals, return_type, expr);
+  }
+  case AST_ATTR: {
+    Symbol name = id();
+    Symbol type_decl = id();
+    Expression init = expression();
+    node_lineno = line;
+    return attr(name, type_decl, init);
+  }
+  default:
+    syntax_error();
+    return NULL;
+  }
+}
+
+Formal AstReader::formal()
+{
+  int line = lineno();
+  if (keyword() != AST_FORMAL)
+    syntax_error();
+  Symbol name = id();
+  Symbol type_decl = id();
+  node_lineno = line;
+  return ::formal(name, type_decl);
+}
+
+//
+// Reads the line number and keyword of an expression, and the symbols
+// that come before its first subexpression, into a new frame.
+//
+void AstReader::begin_expression()
+{
+  if (nframes == frames_size) {
+    frames_size = frames_size ? 2 * frames_size : 64;
+    ExprFrame *f = new ExprFrame[frames_size];
+    if (nframes)
+      memcpy(f, frames, nframes * sizeof(ExprFrame));
+    delete [] frames;
+    frames = f;
+  }
+  ExprFrame *f = &frames[nframes++];
+  f->line = lineno();
+  f->kind = keyword();
+  f->nexprs = 0;
+  switch (f->kind) {
+  case AST_ASSIGN:
+    f->s1 = id();
+    break;
+  case AST_LET:
+    f->s1 = id();
+    f->s2 = id();
+    break;
+  default:
+    break;
+  }
+}
+
+//
+// Reads the components of f up to its next subexpression, and returns
+// whether there is one; false means that all of f has been read but
+// for what follows its last subexpression.
+//
+bool AstReader::more_expressions(ExprFrame *f)
+{
+  switch (f->kind) {
+  case AST_ASSIGN:
+  case AST_NEG:
+  case AST_COMP:
+  case AST_ISVOID:
+    return f->nexprs < 1;
+  case AST_LOOP:
+  case AST_LET:
+  case AST_PLUS:
+  case AST_SUB:
+  case AST_MUL:
+  case AST_DIVIDE:
+  case AST_LT:
+  case AST_EQ:
+  case AST_LEQ:
+    return f->nexprs < 2;
+  case AST_COND:
+    return f->nexprs < 3;
+  case AST_STATIC_DISPATCH:
+  case AST_DISPATCH:
+    // the actual arguments are a parenthesized list
+    if (f->nexprs == 1) {
+      f->s1 = id();
+      if (f->kind == AST_STATIC_DISPATCH)
+	f->s2 = id();
+      expect('(');
+      f->list = nil_Expressions();
+    }
+    if (f->nexprs >= 1 && peek() != '#') {
+      expect(')');
+      return false;
+    }
+    return true;
+  case AST_TYPCASE:
+    // at least one branch, each read up to its expression
+    if (f->nexprs == 0)
+      return true;
+    if (f->nexprs > 1 && peek() != '#')
+      return false;
+    f->branch_line = lineno();
+    if (keyword() != AST_BRANCH)
+      syntax_error();
+    f->branch_name = id();
+    f->branch_type = id();
+    return true;
+  case AST_BLOCK:
+    return f->nexprs == 0 || peek() == '#';
+  case AST_INT_CONST:
+  case AST_BOOL_CONST:
+  case AST_STRING_CONST:
+  case AST_NEW:
+  case AST_NO_EXPR:
+  case AST_OBJECT:
+    return false;
+  default:
+    syntax_error();
+    return false;
+  }
+}
+
+// Adds e, the subexpression just read, to the components of f.
+void AstReader::add_expression(ExprFrame *f, Expression e)
+{
+  switch (f->kind) {
+  case AST_STATIC_DISPATCH:
+  case AST_DISPATCH:
+    if (f->nexprs == 0)
+      f->e[0] = e;
+    else
+      f->list = append_Expressions(f->list, single_Expressions(e));
+    break;
+  case AST_TYPCASE:
+    if (f->nexprs == 0)
+      f->e[0] = e;
+    else {
+      node_lineno = f->branch_line;
+      Case c = branch(f->branch_name, f->branch_type, e);
+      f->cases = f->nexprs == 1 ? single_Cases(c) :
+	append_Cases(f->cases, single_Cases(c));
+    }
+    break;
+  case AST_BLOCK:
+    f->list = f->nexprs == 0 ? single_Expressions(e) :
+      append_Expressions(f->list, single_Expressions(e));
+    break;
+  default:
+    f->e[f->nexprs] = e;
+    break;
+  }
+  f->nexprs++;
+}
+
+// Reads the rest of f, and builds its node.
+Expression AstReader::end_expression(ExprFrame *f)
+{
+  Expression e = NULL;
+  Symbol s1;
+
+  switch (f->kind) {
+  case AST_ASSIGN:
+    node_lineno = f->line;
+    e = assign(f->s1, f->e[0]);
+    break;
+  case AST_STATIC_DISPATCH:
+    node_lineno = f->line;
+    e = static_dispatch(f->e[0], f->s1, f->s2, f->list);
+    break;
+  case AST_DISPATCH:
+    node_lineno = f->line;
+    e = dispatch(f->e[0], f->s1, f->list);
+    break;
+  case AST_COND:
+    node_lineno = f->line;
+    e = cond(f->e[0], f->e[1], f->e[2]);
+    break;
+  case AST_LOOP:
+    node_lineno = f->line;
+    e = loop(f->e[0], f->e[1]);
+    break;
+  case AST_TYPCASE:
+    node_lineno = f->line;
+    e = typcase(f->e[0], f->cases);
+    break;
+  case AST_BLOCK:
+    node_lineno = f->line;
+    e = block(f->list);
+    break;
+  case AST_LET:
+    node_lineno = f->line;
+    e = let(f->s1, f->s2, f->e[0], f->e[1]);
+    break;
+  case AST_PLUS:
+  case AST_SUB:
+  case AST_MUL:
+  case AST_DIVIDE:
+  case AST_LT:
+  case AST_EQ:
+  case AST_LEQ:
+    node_lineno = f->line;
+    switch (f->kind) {
+    case AST_PLUS:   e = plus(f->e[0], f->e[1]); break;
+    case AST_SUB:    e = sub(f->e[0], f->e[1]); break;
+    case AST_MUL:    e = mul(f->e[0], f->e[1]); break;
+    case AST_DIVIDE: e = divide(f->e[0], f->e[1]); break;
+    case AST_LT:     e = lt(f->e[0], f->e[1]); break;
+    case AST_EQ:     e = eq(f->e[0], f->e[1]); break;
+    default:         e = leq(f->e[0], f->e[1]); break;
+    }
+    break;
+  case AST_NEG:
+  case AST_COMP:
+  case AST_ISVOID:
+    node_lineno = f->line;
+    switch (f->kind) {
+    case AST_NEG:  e = neg(f->e[0]); break;
+    case AST_COMP: e = comp(f->e[0]); break;
+    default:       e = isvoid(f->e[0]); break;
+    }
+    break;
+  case AST_INT_CONST:
+    s1 = int_const();
+    node_lineno = f->line;
+    e = ::int_const(s1);
+    break;
+  case AST_BOOL_CONST:
+    // The value is read as an integer constant (and entered into
+    // inttable) just as ast-parse does.
+    s1 = int_const();
+    node_lineno = f->line;
+    e = bool_const(*s1->get_string() == '1');
+    break;
+  case AST_STRING_CONST:
+    s1 = str_const();
+    node_lineno = f->line;
+    e = string_const(s1);
+    break;
+  case AST_NEW:
+    s1 = id();
+    node_lineno = f->line;
+    e = new_(s1);
+    break;
+  case AST_NO_EXPR:
+    node_lineno = f->line;
+    e = no_expr();
+    break;
+  case AST_OBJECT:
+    s1 = id();
+    node_lineno = f->line;
+    e = object(s1);
+    break;
+  default:
+    syntax_error();
+  }
+
+  expect(':');
+  Symbol t = type();
+  if (t)
+    e->set_type(t);
+  return e;
+}
+
+Expression AstReader::expression()
+{
+  int base = nframes;
+  Expression e = NULL;    // the expression last read
+
+  begin_expression();
+  while (nframes > base) {
+    ExprFrame *f = &frames[nframes - 1];
+    if (e != NULL) {
+      add_expression(f, e);
+      e = NULL;
+    }
+    if (more_expressions(f))
+      begin_expression();
+    else {
+      e = end_expression(f);
+      nframes--;
+    }
+  }
+  return e;
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+//  read_text_ast
+//
+//  The whole of f is read into one buffer, in large blocks, and parsed.
+//
+/////////////////////////////////////////////////////////////////////////
+
+Program read_text_ast(FILE *f)
+{
+  long room = 1 << 20;
+  long size = 0;
+  char *buf = (char *) malloc(room + 1);
+
+  for (;;) {
+    if (buf == NULL) {
+      cerr << "Error in ast parsing: out of memory" << endl;
+      exit(1);
+    }
+    size_t n = fread(buf + size, 1, room - size, f);
+    if (n == 0)
+      break;
+    size += n;
+    if (size == room) {
+      room *= 2;
+      buf = (char *) realloc(buf, room + 1);
+    }
+  }
+  buf[size] = '\0';
+
+  AstReader reader(buf);
+  Program prog = reader.program();
+  free(buf);
+  return prog;
+}
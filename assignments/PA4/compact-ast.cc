@@ -0,0 +1,948 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// file: compact-ast.cc
+//
+// Conversion between cool-tree.h trees and the compact encoding of
+// compact-ast.h.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "compact-ast.h"
+
+extern __thread int node_lineno;
+
+//
+// The arrays of a CompactAst grow by doubling.
+//
+template <class T> static T *grow_array(T *a, int used, int &size)
+{
+  int new_size = size ? 2 * size : 256;
+  T *b = new T[new_size];
+  for (int i = 0; i < used; i++)
+    b[i] = a[i];
+  delete [] a;
+  size = new_size;
+  return b;
+}
+
+CompactAst::CompactAst() :
+  owned(true), nodes_size(0), ops_size(0),
+  kind(NULL), first_op(NULL), ops(NULL), line(NULL),
+  nnodes(0), nops(0)
+{
+  // first_op always has a final entry marking the end of the last node.
+  first_op = new uint32_t[1];
+  first_op[0] = 0;
+}
+
+CompactAst::~CompactAst()
+{
+  if (owned) {
+    delete [] kind;
+    delete [] first_op;
+    delete [] ops;
+    delete [] line;
+  }
+}
+
+void CompactAst::clear()
+{
+  if (!owned) {
+    // The arrays belong to a loaded file; start over with our own.
+    owned = true;
+    kind = NULL;
+    ops = NULL;
+    line = NULL;
+    nodes_size = ops_size = 0;
+    first_op = new uint32_t[1];
+  }
+  nnodes = nops = 0;
+  first_op[0] = 0;
+}
+
+uint32_t CompactAst::begin_node(AstKind k, int line_number)
+{
+  assert(owned);
+  if (nnodes + 1 >= nodes_size) {
+    int size = nodes_size;
+    kind = grow_array(kind, nnodes, size);
+    size = nodes_size;
+    line = grow_array(line, nnodes, size);
+    size = nodes_size;
+    first_op = grow_array(first_op, nnodes + 1, size);
+    nodes_size = size;
+  }
+  kind[nnodes] = (uint8_t) k;
+  line[nnodes] = line_number;
+  first_op[nnodes] = nops;
+  nnodes++;
+  first_op[nnodes] = nops;
+  return nnodes - 1;
+}
+
+void CompactAst::add_op(uint32_t x)
+{
+  if (nops == ops_size)
+    ops = grow_array(ops, nops, ops_size);
+  ops[nops++] = x;
+  first_op[nnodes] = nops;
+}
+
+//
+// Symbol references
+//
+uint32_t CompactAst::symbol_ref(Symbol s)
+{
+  if (s == NULL)
+    return NO_SYMBOL;
+
+  int i = s->get_index();
+  assert(i < (1 << 30));
+  if (i < idtable.size() && (Symbol) idtable.lookup(i) == s)
+    return ((uint32_t) SYM_ID << 30) | i;
+  if (i < stringtable.size() && (Symbol) stringtable.lookup(i) == s)
+    return ((uint32_t) SYM_STRING << 30) | i;
+  assert(i < inttable.size() && (Symbol) inttable.lookup(i) == s);
+  return ((uint32_t) SYM_INT << 30) | i;
+}
+
+Symbol CompactAst::symbol(uint32_t r)
+{
+  if (r == NO_SYMBOL)
+    return NULL;
+
+  int i = r & ((1 << 30) - 1);
+  switch (r >> 30) {
+  case SYM_ID:     return idtable.lookup(i);
+  case SYM_STRING: return stringtable.lookup(i);
+  default:         return inttable.lookup(i);
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// Encoding
+//
+// The tree is encoded by a tree_walker, so that encoding a deep tree
+// does not recurse.  Each node is added by its encode_node hook after
+// its subtrees, whose node numbers it gets in kids, and it returns its
+// own node number.  The numbers of the encoded subtrees of the nodes
+// being walked are kept on a stack, as in tree_node::copy.
+//
+///////////////////////////////////////////////////////////////////////////
+
+class encode_walker : public tree_walker {
+  CompactAst &a;
+  uint32_t *encoded;
+  int nencoded;
+  int size;
+public:
+  encode_walker(CompactAst &c) : a(c), encoded(NULL), nencoded(0), size(0) { }
+  ~encode_walker()                      { delete [] encoded; }
+  void post(tree_node *t, int n);
+  uint32_t result()                     { return encoded[0]; }
+};
+
+void encode_walker::post(tree_node *t, int n)
+{
+  int nkids = t->children();
+  uint32_t x = t->encode_node(a, encoded + nencoded - nkids);
+
+  nencoded -= nkids;
+  if (nencoded == size)
+    encoded = grow_array(encoded, nencoded, size);
+  encoded[nencoded++] = x;
+}
+
+uint32_t program_class::encode(CompactAst &a)
+{
+  encode_walker w(a);
+  w.walk(this, 0);
+  return w.result();
+}
+
+// The operands of a list are its elements.
+template <class Elem> uint32_t list_node<Elem>::encode_node(CompactAst &a, uint32_t *kids)
+{
+  uint32_t n = a.begin_node(AST_LIST, line_number);
+  for (int i = 0; i < len(); i++)
+    a.add_op(kids[i]);
+  return n;
+}
+
+template uint32_t list_node<Class_>::encode_node(CompactAst &, uint32_t *);
+template uint32_t list_node<Feature>::encode_node(CompactAst &, uint32_t *);
+template uint32_t list_node<Formal>::encode_node(CompactAst &, uint32_t *);
+template uint32_t list_node<Expression>::encode_node(CompactAst &, uint32_t *);
+template uint32_t list_node<Case>::encode_node(CompactAst &, uint32_t *);
+
+#define SYM(s) CompactAst::symbol_ref(s)
+
+uint32_t program_class::encode_node(CompactAst &a, uint32_t *kids)
+{
+  uint32_t n = a.begin_node(AST_PROGRAM, line_number);
+  a.add_op(kids[0]);
+  return n;
+}
+
+uint32_t class__class::encode_node(CompactAst &a, uint32_t *kids)
+{
+  uint32_t n = a.begin_node(AST_CLASS, line_number);
+  a.add_op(SYM(name));
+  a.add_op(SYM(parent));
+  a.add_op(kids[0]);
+  a.add_op(SYM(filename));
+  return n;
+}
+
+uint32_t method_class::encode_node(CompactAst &a, uint32_t *kids)
+{
+  uint32_t n = a.begin_node(AST_METHOD, line_number);
+  a.add_op(SYM(name));
+  a.add_op(kids[0]);
+  a.add_op(SYM(return_type));
+  a.add_op(kids[1]);
+  return n;
+}
+
+uint32_t attr_class::encode_node(CompactAst &a, uint32_t *kids)
+{
+  uint32_t n = a.begin_node(AST_ATTR, line_number);
+  a.add_op(SYM(name));
+  a.add_op(SYM(type_decl));
+  a.add_op(kids[0]);
+  return n;
+}
+
+uint32_t formal_class::encode_node(CompactAst &a, uint32_t *)
+{
+  uint32_t n = a.begin_node(AST_FORMAL, line_number);
+  a.add_op(SYM(name));
+  a.add_op(SYM(type_decl));
+  return n;
+}
+
+uint32_t branch_class::encode_node(CompactAst &a, uint32_t *kids)
+{
+  uint32_t n = a.begin_node(AST_BRANCH, line_number);
+  a.add_op(SYM(name));
+  a.add_op(SYM(type_decl));
+  a.add_op(kids[0]);
+  return n;
+}
+
+uint32_t assign_class::encode_node(CompactAst &a, uint32_t *kids)
+{
+  uint32_t n = a.begin_node(AST_ASSIGN, line_number);
+  a.add_op(SYM(name));
+  a.add_op(kids[0]);
+  a.add_op(SYM(type));
+  return n;
+}
+
+uint32_t static_dispatch_class::encode_node(CompactAst &a, uint32_t *kids)
+{
+  uint32_t n = a.begin_node(AST_STATIC_DISPATCH, line_number);
+  a.add_op(kids[0]);
+  a.add_op(SYM(type_name));
+  a.add_op(SYM(name));
+  a.add_op(kids[1]);
+  a.add_op(SYM(type));
+  return n;
+}
+
+uint32_t dispatch_class::encode_node(CompactAst &a, uint32_t *kids)
+{
+  uint32_t n = a.begin_node(AST_DISPATCH, line_number);
+  a.add_op(kids[0]);
+  a.add_op(SYM(name));
+  a.add_op(kids[1]);
+  a.add_op(SYM(type));
+  return n;
+}
+
+uint32_t cond_class::encode_node(CompactAst &a, uint32_t *kids)
+{
+  uint32_t n = a.begin_node(AST_COND, line_number);
+  a.add_op(kids[0]);
+  a.add_op(kids[1]);
+  a.add_op(kids[2]);
+  a.add_op(SYM(type));
+  return n;
+}
+
+uint32_t loop_class::encode_node(CompactAst &a, uint32_t *kids)
+{
+  uint32_t n = a.begin_node(AST_LOOP, line_number);
+  a.add_op(kids[0]);
+  a.add_op(kids[1]);
+  a.add_op(SYM(type));
+  return n;
+}
+
+uint32_t typcase_class::encode_node(CompactAst &a, uint32_t *kids)
+{
+  uint32_t n = a.begin_node(AST_TYPCASE, line_number);
+  a.add_op(kids[0]);
+  a.add_op(kids[1]);
+  a.add_op(SYM(type));
+  return n;
+}
+
+uint32_t block_class::encode_node(CompactAst &a, uint32_t *kids)
+{
+  uint32_t n = a.begin_node(AST_BLOCK, line_number);
+  a.add_op(kids[0]);
+  a.add_op(SYM(type));
+  return n;
+}
+
+uint32_t let_class::encode_node(CompactAst &a, uint32_t *kids)
+{
+  uint32_t n = a.begin_node(AST_LET, line_number);
+  a.add_op(SYM(identifier));
+  a.add_op(SYM(type_decl));
+  a.add_op(kids[0]);
+  a.add_op(kids[1]);
+  a.add_op(SYM(type));
+  return n;
+}
+
+//
+// The binary and unary operators differ only in their kind.
+//
+static uint32_t encode_binary(CompactAst &a, AstKind k, int line_number,
+			      uint32_t *kids, Symbol type)
+{
+  uint32_t n = a.begin_node(k, line_number);
+  a.add_op(kids[0]);
+  a.add_op(kids[1]);
+  a.add_op(SYM(type));
+  return n;
+}
+
+static uint32_t encode_unary(CompactAst &a, AstKind k, int line_number,
+			     uint32_t *kids, Symbol type)
+{
+  uint32_t n = a.begin_node(k, line_number);
+  a.add_op(kids[0]);
+  a.add_op(SYM(type));
+  return n;
+}
+
+uint32_t plus_class::encode_node(CompactAst &a, uint32_t *kids)
+{ return encode_binary(a, AST_PLUS, line_number, kids, type); }
+
+uint32_t sub_class::encode_node(CompactAst &a, uint32_t *kids)
+{ return encode_binary(a, AST_SUB, line_number, kids, type); }
+
+uint32_t mul_class::encode_node(CompactAst &a, uint32_t *kids)
+{ return encode_binary(a, AST_MUL, line_number, kids, type); }
+
+uint32_t divide_class::encode_node(CompactAst &a, uint32_t *kids)
+{ return encode_binary(a, AST_DIVIDE, line_number, kids, type); }
+
+uint32_t lt_class::encode_node(CompactAst &a, uint32_t *kids)
+{ return encode_binary(a, AST_LT, line_number, kids, type); }
+
+uint32_t eq_class::encode_node(CompactAst &a, uint32_t *kids)
+{ return encode_binary(a, AST_EQ, line_number, kids, type); }
+
+uint32_t leq_class::encode_node(CompactAst &a, uint32_t *kids)
+{ return encode_binary(a, AST_LEQ, line_number, kids, type); }
+
+uint32_t neg_class::encode_node(CompactAst &a, uint32_t *kids)
+{ return encode_unary(a, AST_NEG, line_number, kids, type); }
+
+uint32_t comp_class::encode_node(CompactAst &a, uint32_t *kids)
+{ return encode_unary(a, AST_COMP, line_number, kids, type); }
+
+uint32_t isvoid_class::encode_node(CompactAst &a, uint32_t *kids)
+{ return encode_unary(a, AST_ISVOID, line_number, kids, type); }
+
+uint32_t int_const_class::encode_node(CompactAst &a, uint32_t *)
+{
+  uint32_t n = a.begin_node(AST_INT_CONST, line_number);
+  a.add_op(SYM(token));
+  a.add_op(SYM(type));
+  return n;
+}
+
+uint32_t bool_const_class::encode_node(CompactAst &a, uint32_t *)
+{
+  uint32_t n = a.begin_node(AST_BOOL_CONST, line_number);
+  a.add_op((uint32_t) val);
+  a.add_op(SYM(type));
+  return n;
+}
+
+uint32_t string_const_class::encode_node(CompactAst &a, uint32_t *)
+{
+  uint32_t n = a.begin_node(AST_STRING_CONST, line_number);
+  a.add_op(SYM(token));
+  a.add_op(SYM(type));
+  return n;
+}
+
+uint32_t new__class::encode_node(CompactAst &a, uint32_t *)
+{
+  uint32_t n = a.begin_node(AST_NEW, line_number);
+  a.add_op(SYM(type_name));
+  a.add_op(SYM(type));
+  return n;
+}
+
+uint32_t no_expr_class::encode_node(CompactAst &a, uint32_t *)
+{
+  uint32_t n = a.begin_node(AST_NO_EXPR, line_number);
+  a.add_op(SYM(type));
+  return n;
+}
+
+uint32_t object_class::encode_node(CompactAst &a, uint32_t *)
+{
+  uint32_t n = a.begin_node(AST_OBJECT, line_number);
+  a.add_op(SYM(name));
+  a.add_op(SYM(type));
+  return n;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// Decoding
+//
+// Since children come before their parents, the nodes are built in
+// order of node number; built[i] is the tree node for node i.  Lists
+// are built by the node that refers to them.
+//
+///////////////////////////////////////////////////////////////////////////
+
+template <class Elem> static list_node<Elem> *decode_list(CompactAst &a, uint32_t n,
+							  tree_node **built)
+{
+  node_lineno = a.line[n];
+  int len = a.arity(n);
+  if (len == 0)
+    return list_node<Elem>::nil();
+
+  list_node<Elem> *l = list_node<Elem>::single((Elem) built[a.op(n, 0)]);
+  for (int i = 1; i < len; i++)
+    l = list_node<Elem>::append(l, list_node<Elem>::single((Elem) built[a.op(n, i)]));
+  return l;
+}
+
+Program CompactAst::decode()
+{
+  int save_lineno = node_lineno;
+  tree_node **built = new tree_node *[nnodes];
+
+#define S(i)   symbol(op(n, i))
+#define E(i)   ((Expression) built[op(n, i)])
+
+  for (uint32_t n = 0; n < (uint32_t) nnodes; n++) {
+    Classes classes = NULL;
+    Features features = NULL;
+    Formals formals = NULL;
+    Expressions exprs = NULL;
+    Cases cases = NULL;
+    tree_node *t = NULL;
+
+    // lists first, since decode_list sets node_lineno
+    switch (kind[n]) {
+    case AST_PROGRAM:         classes = decode_list<Class_>(*this, op(n, 0), built); break;
+    case AST_CLASS:           features = decode_list<Feature>(*this, op(n, 2), built); break;
+    case AST_METHOD:          formals = decode_list<Formal>(*this, op(n, 1), built); break;
+    case AST_STATIC_DISPATCH: exprs = decode_list<Expression>(*this, op(n, 3), built); break;
+    case AST_DISPATCH:        exprs = decode_list<Expression>(*this, op(n, 2), built); break;
+    case AST_TYPCASE:         cases = decode_list<Case>(*this, op(n, 1), built); break;
+    case AST_BLOCK:           exprs = decode_list<Expression>(*this, op(n, 0), built); break;
+    }
+
+    node_lineno = line[n];
+    switch (kind[n]) {
+    case AST_PROGRAM:         t = program(classes); break;
+    case AST_CLASS:           t = class_(S(0), S(1), features, S(3)); break;
+    case AST_METHOD:          t = method(S(0), formals, S(2), E(3)); break;
+    case AST_ATTR:            t = attr(S(0), S(1), E(2)); break;
+    case AST_FORMAL:          t = formal(S(0), S(1)); break;
+    case AST_BRANCH:          t = branch(S(0), S(1), E(2)); break;
+    case AST_ASSIGN:          t = assign(S(0), E(1)); break;
+    case AST_STATIC_DISPATCH: t = static_dispatch(E(0), S(1), S(2), exprs); break;
+    case AST_DISPATCH:        t = dispatch(E(0), S(1), exprs); break;
+    case AST_COND:            t = cond(E(0), E(1), E(2)); break;
+    case AST_LOOP:            t = loop(E(0), E(1)); break;
+    case AST_TYPCASE:         t = typcase(E(0), cases); break;
+    case AST_BLOCK:           t = block(exprs); break;
+    case AST_LET:             t = let(S(0), S(1), E(2), E(3)); break;
+    case AST_PLUS:            t = plus(E(0), E(1)); break;
+    case AST_SUB:             t = sub(E(0), E(1)); break;
+    case AST_MUL:             t = mul(E(0), E(1)); break;
+    case AST_DIVIDE:          t = divide(E(0), E(1)); break;
+    case AST_NEG:             t = neg(E(0)); break;
+    case AST_LT:              t = lt(E(0), E(1)); break;
+    case AST_EQ:              t = eq(E(0), E(1)); break;
+    case AST_LEQ:             t = leq(E(0), E(1)); break;
+    case AST_COMP:            t = comp(E(0)); break;
+    case AST_INT_CONST:       t = int_const(S(0)); break;
+    case AST_BOOL_CONST:      t = bool_const((Boolean) op(n, 0)); break;
+    case AST_STRING_CONST:    t = string_const(S(0)); break;
+    case AST_NEW:             t = new_(S(0)); break;
+    case AST_ISVOID:          t = isvoid(E(0)); break;
+    case AST_NO_EXPR:         t = no_expr(); break;
+    case AST_OBJECT:          t = object(S(0)); break;
+    case AST_LIST:            break;
+    default:
+      cerr << "compact AST: bad node kind " << (int) kind[n] << "\n";
+      exit(1);
+    }
+
+    // every expression has its type as its last operand
+    if (kind[n] >= AST_ASSIGN && kind[n] <= AST_OBJECT)
+      ((Expression) t)->set_type(symbol(op(n, arity(n) - 1)));
+    built[n] = t;
+  }
+
+#undef S
+#undef E
+
+  Program p = (Program) built[root()];
+  delete [] built;
+  node_lineno = save_lineno;
+  return p;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// Binary AST files
+//
+// A binary AST file holds a CompactAst together with the string tables
+// its symbol references index into.  All integers are 32 bits in the
+// byte order of the machine that wrote the file.  The file is:
+//
+//    a BinaryAstHeader
+//
+//    the string table section: the symbols of idtable, stringtable and
+//    inttable that the nodes refer to, table by table.  Each entry is
+//    its length, its characters and a terminating NUL, padded with
+//    NULs to a multiple of 4 bytes.  A symbol reference indexes into
+//    this section rather than into the writer's tables.
+//
+//    the node section, at header.nodes_offset:
+//        uint32_t first_op[nnodes + 1]
+//        uint32_t ops[nops]
+//        int32_t  line[nnodes]
+//        uint8_t  kind[nnodes]
+//
+// The version is increased whenever the layout or the node encoding
+// changes; a reader rejects any version but its own.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#define BINARY_AST_MAGIC   "COOL-AST"
+#define BINARY_AST_VERSION 1
+
+struct BinaryAstHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t ntable[3];       // entries of idtable, stringtable, inttable
+  uint32_t nnodes;
+  uint32_t nops;
+  uint32_t nodes_offset;    // byte offset of the node section
+  uint32_t size;            // byte size of the file
+};
+
+//
+// The operands of each kind of node, one character per operand:
+//
+//    E       an Expression node
+//    c f m e b   a list (AST_LIST node) of Classes, Features, Formals,
+//            Expressions or Cases
+//    S       a symbol reference
+//    V       a plain value
+//
+// The operands of AST_LIST nodes are the elements.  node_phylum gives
+// the phylum of each kind of node in the same letters, in upper case.
+//
+static const char *operand_kinds[] = {
+  "c",       // AST_PROGRAM
+  "SSfS",    // AST_CLASS
+  "SmSE",    // AST_METHOD
+  "SSE",     // AST_ATTR
+  "SS",      // AST_FORMAL
+  "SSE",     // AST_BRANCH
+  "SES",     // AST_ASSIGN
+  "ESSeS",   // AST_STATIC_DISPATCH
+  "ESeS",    // AST_DISPATCH
+  "EEES",    // AST_COND
+  "EES",     // AST_LOOP
+  "EbS",     // AST_TYPCASE
+  "eS",      // AST_BLOCK
+  "SSEES",   // AST_LET
+  "EES",     // AST_PLUS
+  "EES",     // AST_SUB
+  "EES",     // AST_MUL
+  "EES",     // AST_DIVIDE
+  "ES",      // AST_NEG
+  "EES",     // AST_LT
+  "EES",     // AST_EQ
+  "EES",     // AST_LEQ
+  "ES",      // AST_COMP
+  "SS",      // AST_INT_CONST
+  "VS",      // AST_BOOL_CONST
+  "SS",      // AST_STRING_CONST
+  "SS",      // AST_NEW
+  "ES",      // AST_ISVOID
+  "S",       // AST_NO_EXPR
+  "SS",      // AST_OBJECT
+  ""         // AST_LIST
+};
+
+static const char node_phylum[] = "PCFFMBEEEEEEEEEEEEEEEEEEEEEEEE-";
+
+static void bad_binary_ast(char *msg)
+{
+  cerr << "binary AST: " << msg << "\n";
+  exit(1);
+}
+
+//
+// Writing
+//
+// The symbols of a tree are renumbered in the order in which a textual
+// dump (dump_with_types) first mentions them.  A reader that starts
+// with empty tables then enters them in the same order as ast-parse
+// does, and both formats of a tree give the same string tables; the
+// order matters, since cgen emits its constants in table order.  As in
+// a dump, the value of a bool_const counts as a mention of the int
+// constant 0 or 1.
+//
+static void write_table(ostream &s, Symbol *syms, int n)
+{
+  static const char zeros[4] = { 0, 0, 0, 0 };
+
+  for (int i = 0; i < n; i++) {
+    uint32_t len = syms[i]->get_len();
+    s.write((char *) &len, sizeof(len));
+    s.write(syms[i]->get_string(), len);
+    s.write(zeros, 4 - len % 4);
+  }
+}
+
+static uint32_t table_bytes(Symbol *syms, int n)
+{
+  uint32_t bytes = 0;
+  for (int i = 0; i < n; i++)
+    bytes += 4 + (syms[i]->get_len() / 4 + 1) * 4;
+  return bytes;
+}
+
+// The position in the operands of a node of kind k of the i-th operand
+// dumped: a class dumps its filename before its features.
+static int dump_operand(int k, int i)
+{
+  return (k == AST_CLASS && i >= 2) ? 5 - i : i;
+}
+
+void CompactAst::write(ostream &s)
+{
+  BinaryAstHeader h;
+  uint32_t bool_value[2] = { symbol_ref(inttable.add_string("0")),
+                             symbol_ref(inttable.add_string("1")) };
+  int table_size[3] = { idtable.size(), stringtable.size(), inttable.size() };
+  int *renumber[3];         // new index of each entry, or -1 if unused
+  Symbol *syms[3];          // the used symbols, by new index
+  int nsyms[3];
+
+  for (int t = SYM_ID; t <= SYM_INT; t++) {
+    renumber[t] = new int[table_size[t]];
+    for (int i = 0; i < table_size[t]; i++)
+      renumber[t][i] = -1;
+    syms[t] = new Symbol[table_size[t]];
+    nsyms[t] = 0;
+  }
+
+  // Walk the tree in dump order, rewriting the symbol references of a
+  // copy of the operands.
+  uint32_t *new_ops = new uint32_t[nops];
+  memcpy(new_ops, ops, 4 * nops);
+  uint32_t *stack = new uint32_t[nnodes];
+  int *next = new int[nnodes];
+  int sp = 0;
+  stack[sp] = root();
+  next[sp++] = 0;
+  while (sp > 0) {
+    uint32_t n = stack[sp - 1];
+    int i = next[sp - 1]++;
+    if (i == arity(n)) {
+      sp--;
+      continue;
+    }
+    if (kind[n] == AST_LIST) {
+      stack[sp] = op(n, i);
+      next[sp++] = 0;
+      continue;
+    }
+    int j = dump_operand(kind[n], i);
+    char opk = operand_kinds[kind[n]][j];
+    uint32_t &x = new_ops[first_op[n] + j];
+    if (opk == 'S' || opk == 'V') {
+      uint32_t r = x;
+      if (opk == 'V')
+	r = bool_value[x != 0];
+      if (r == NO_SYMBOL)
+	continue;
+      int t = r >> 30;
+      int e = r & ((1 << 30) - 1);
+      if (renumber[t][e] < 0) {
+	renumber[t][e] = nsyms[t];
+	syms[t][nsyms[t]++] = symbol(r);
+      }
+      if (opk == 'S')
+	x = ((uint32_t) t << 30) | renumber[t][e];
+    } else {
+      stack[sp] = x;
+      next[sp++] = 0;
+    }
+  }
+
+  memcpy(h.magic, BINARY_AST_MAGIC, sizeof(h.magic));
+  h.version = BINARY_AST_VERSION;
+  h.nodes_offset = sizeof(h);
+  for (int t = SYM_ID; t <= SYM_INT; t++) {
+    h.ntable[t] = nsyms[t];
+    h.nodes_offset += table_bytes(syms[t], nsyms[t]);
+  }
+  h.nnodes = nnodes;
+  h.nops = nops;
+  h.size = h.nodes_offset + 4 * (nnodes + 1) + 4 * nops + 4 * nnodes + nnodes;
+
+  s.write((char *) &h, sizeof(h));
+  for (int t = SYM_ID; t <= SYM_INT; t++)
+    write_table(s, syms[t], nsyms[t]);
+  s.write((char *) first_op, 4 * (nnodes + 1));
+  s.write((char *) new_ops, 4 * nops);
+  s.write((char *) line, 4 * nnodes);
+  s.write((char *) kind, nnodes);
+
+  for (int t = SYM_ID; t <= SYM_INT; t++) {
+    delete [] renumber[t];
+    delete [] syms[t];
+  }
+  delete [] new_ops;
+  delete [] stack;
+  delete [] next;
+}
+
+void program_class::dump_binary(ostream &s)
+{
+  CompactAst a;
+  encode(a);
+  a.write(s);
+}
+
+//
+// Reading
+//
+// read_table enters the strings of one table of the file into tbl.  In
+// remap[i] it records the index in tbl of the file's entry i, and it
+// returns whether every entry kept its index.
+//
+template <class Elem> static bool read_table(char *&p, char *end, uint32_t n,
+					     StringTable<Elem> &tbl, int *remap)
+{
+  bool same = true;
+
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t len;
+    if (end - p < 4)
+      bad_binary_ast("truncated string table");
+    memcpy(&len, p, 4);
+    p += 4;
+    // in 64 bits, so that a huge len cannot wrap around
+    uint64_t bytes = ((uint64_t) len / 4 + 1) * 4;
+    if (bytes > (uint64_t) (end - p) || p[len] != '\0')
+      bad_binary_ast("bad string table entry");
+    remap[i] = tbl.add_string(p, len)->get_index();
+    same = same && remap[i] == (int) i;
+    p += bytes;
+  }
+  return same;
+}
+
+void CompactAst::load(char *buf, long size)
+{
+  BinaryAstHeader h;
+
+  if (size < (long) sizeof(h))
+    bad_binary_ast("file too short");
+  memcpy(&h, buf, sizeof(h));
+  if (memcmp(h.magic, BINARY_AST_MAGIC, sizeof(h.magic)) != 0)
+    bad_binary_ast("not a binary AST file");
+  if (h.version != BINARY_AST_VERSION)
+    bad_binary_ast("unsupported version");
+  if (h.size != size || h.nodes_offset % 4 != 0 || h.nnodes == 0 ||
+      (uint64_t) h.nodes_offset + 4 * ((uint64_t) h.nnodes + 1) +
+      4 * (uint64_t) h.nops + 5 * (uint64_t) h.nnodes != h.size)
+    bad_binary_ast("bad section sizes");
+
+  // The string table section.
+  int *remap[3];
+  bool same = true;
+  char *p = buf + sizeof(h);
+  char *end = buf + h.nodes_offset;
+  remap[SYM_ID] = new int[h.ntable[SYM_ID]];
+  same = read_table(p, end, h.ntable[SYM_ID], idtable, remap[SYM_ID]) && same;
+  remap[SYM_STRING] = new int[h.ntable[SYM_STRING]];
+  same = read_table(p, end, h.ntable[SYM_STRING], stringtable, remap[SYM_STRING]) && same;
+  remap[SYM_INT] = new int[h.ntable[SYM_INT]];
+  same = read_table(p, end, h.ntable[SYM_INT], inttable, remap[SYM_INT]) && same;
+
+  // The node section is used in place.
+  clear();
+  if (owned) {
+    delete [] kind;
+    delete [] first_op;
+    delete [] ops;
+    delete [] line;
+  }
+  owned = false;
+  nnodes = h.nnodes;
+  nops = h.nops;
+  first_op = (uint32_t *) (buf + h.nodes_offset);
+  ops = first_op + nnodes + 1;
+  line = (int *) (ops + nops);
+  kind = (uint8_t *) (line + nnodes);
+
+  // Check the nodes, so that decode can trust them: every child comes
+  // before its parent and has the phylum its position calls for.
+  if (first_op[0] != 0 || first_op[nnodes] != (uint32_t) nops)
+    bad_binary_ast("bad operand offsets");
+  for (int n = 0; n < nnodes; n++) {
+    if (kind[n] > AST_LIST || first_op[n] > first_op[n + 1])
+      bad_binary_ast("bad node");
+    if (kind[n] == AST_LIST)
+      continue;
+    const char *opk = operand_kinds[kind[n]];
+    if (arity(n) != (int) strlen(opk))
+      bad_binary_ast("bad node arity");
+    for (int i = 0; opk[i]; i++) {
+      uint32_t x = op(n, i);
+      if (opk[i] == 'S') {
+	if (x != NO_SYMBOL &&
+	    ((x >> 30) > SYM_INT || (x & ((1 << 30) - 1)) >= h.ntable[x >> 30]))
+	  bad_binary_ast("bad symbol reference");
+      } else if (opk[i] == 'E') {
+	if (x >= (uint32_t) n || node_phylum[kind[x]] != 'E')
+	  bad_binary_ast("bad child reference");
+      } else if (opk[i] != 'V') {
+	if (x >= (uint32_t) n || kind[x] != AST_LIST)
+	  bad_binary_ast("bad list reference");
+	for (int j = 0; j < arity(x); j++)
+	  if (op(x, j) >= x || node_phylum[kind[op(x, j)]] != opk[i] - 'a' + 'A')
+	    bad_binary_ast("bad list element");
+      }
+    }
+  }
+  if (kind[root()] != AST_PROGRAM)
+    bad_binary_ast("the root is not a program");
+
+  // If the string tables already held other strings, the symbol
+  // references must be rewritten, so the nodes are copied into arrays
+  // of our own.
+  if (!same) {
+    uint8_t *new_kind = new uint8_t[nnodes];
+    uint32_t *new_first_op = new uint32_t[nnodes + 1];
+    uint32_t *new_ops = new uint32_t[nops];
+    int *new_line = new int[nnodes];
+    memcpy(new_kind, kind, nnodes);
+    memcpy(new_first_op, first_op, 4 * (nnodes + 1));
+    memcpy(new_ops, ops, 4 * nops);
+    memcpy(new_line, line, 4 * nnodes);
+    kind = new_kind;
+    first_op = new_first_op;
+    ops = new_ops;
+    line = new_line;
+    owned = true;
+    nodes_size = nnodes + 1;
+    ops_size = nops;
+
+    for (int n = 0; n < nnodes; n++) {
+      if (kind[n] == AST_LIST)
+	continue;
+      const char *opk = operand_kinds[kind[n]];
+      for (int i = 0; opk[i]; i++) {
+	uint32_t &x = ops[first_op[n] + i];
+	if (opk[i] == 'S' && x != NO_SYMBOL)
+	  x = (x & (3u << 30)) | remap[x >> 30][x & ((1 << 30) - 1)];
+      }
+    }
+  }
+  delete [] remap[SYM_ID];
+  delete [] remap[SYM_STRING];
+  delete [] remap[SYM_INT];
+}
+
+Program read_binary_ast(int fd)
+{
+  struct stat st;
+  char *buf = NULL;
+  long size = 0;
+  bool mapped = false;
+
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    size = st.st_size;
+    buf = (char *) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    mapped = buf != (char *) MAP_FAILED;
+    if (!mapped)
+      buf = NULL;
+  }
+  if (!mapped) {
+    // Not a regular file (a pipe, say): read it into memory.
+    long room = 1 << 16;
+    buf = (char *) malloc(room);
+    size = 0;
+    for (;;) {
+      if (size == room) {
+	room *= 2;
+	buf = (char *) realloc(buf, room);
+      }
+      if (buf == NULL)
+	bad_binary_ast("out of memory");
+      long n = read(fd, buf + size, room - size);
+      if (n < 0)
+	bad_binary_ast("read error");
+      if (n == 0)
+	break;
+      size += n;
+    }
+  }
+
+  // The nodes are decoded straight out of the file's buffer, which is
+  // released once the tree is built.
+  Program p;
+  {
+    CompactAst a;
+    a.load(buf, size);
+    p = a.decode();
+  }
+  if (mapped)
+    munmap(buf, size);
+  else
+    free(buf);
+  return p;
+}
@@ -5,11 +5,14 @@
 #define COOL_TREE_HANDCODE_H
 
 #include <iostream>
+#include <stdint.h>
 #include "tree.h"
 #include "cool.h"
 #include "stringtab.h"
+#include "symtab.h"
+#include "symbolmap.h"
 #define yylineno curr_lineno;
-extern int yylineno;
+extern __thread int yylineno;
 
 inline Boolean copy_Boolean(Boolean b) {return b; }
 inline void assert_Boolean(Boolean) {}
@@ -32,6 +35,12 @@ class Expression_class;
 typedef Expression_class *Expression;
 class Case_class;
 typedef Case_class *Case;
+class CompactAst;
+
+// The scopes of identifiers and the classes by name, as the type
+// checker (semant.cc) passes them around.
+typedef SymbolTable<Symbol, Symbol> *SymTab;
+typedef SymbolMap<Class_> &MAP;
 
 typedef list_node<Class_> Classes_class;
 typedef Classes_class *Classes;
@@ -45,61 +54,115 @@ typedef list_node<Case> Cases_class;
 typedef Cases_class *Cases;
 
 #define Program_EXTRAS                          \
-virtual void semant() = 0;			\
-virtual void dump_with_types(ostream&, int) = 0; 
+virtual uint32_t encode(CompactAst&) = 0;       \
+virtual void dump_binary(ostream&) = 0;         \
+virtual void semant() = 0;
 
 
 
 #define program_EXTRAS                          \
-void semant();     				\
-void dump_with_types(ostream&, int);            
+uint32_t encode(CompactAst&);                   \
+uint32_t encode_node(CompactAst&, uint32_t *);  \
+void dump_binary(ostream&);                     \
+void semant();
 
 #define Class__EXTRAS                   \
 virtual Symbol get_filename() = 0;      \
-virtual void dump_with_types(ostream&,int) = 0; 
+virtual Symbol getName() = 0;           \
+virtual Symbol getParent() = 0;         \
+virtual Features getFeatures() = 0;
 
 
 #define class__EXTRAS                                 \
-Symbol get_filename() { return filename; }             \
-void dump_with_types(ostream&,int);                    
+uint32_t encode_node(CompactAst&, uint32_t *);        \
+Symbol get_filename() { return filename; }            \
+Symbol getName() { return name; }                     \
+Symbol getParent() { return parent; }                 \
+Features getFeatures() { return features; }
 
 
+// The members the semantic analyzer (semant.cc) uses.  store enters a
+// feature into the method or attribute table of its class; typeChecker
+// checks its body.  An attr has no formals.
 #define Feature_EXTRAS                                        \
-virtual void dump_with_types(ostream&,int) = 0; 
+virtual bool isMethod() = 0;                                  \
+virtual Symbol getName() = 0;                                 \
+virtual Symbol getReturnType() = 0;                           \
+virtual Formals getFormals() { return NULL; }                 \
+virtual void checkFormals(Formals, SymTab, Class_) { }        \
+virtual void store() = 0;                                     \
+virtual Symbol typeChecker(SymTab, MAP, Class_) = 0;
 
 
 #define Feature_SHARED_EXTRAS                                       \
-void dump_with_types(ostream&,int);    
-
+uint32_t encode_node(CompactAst&, uint32_t *);                      \
+void store();                                                       \
+Symbol typeChecker(SymTab, MAP, Class_);
 
+#define method_EXTRAS                                 \
+bool isMethod() { return true; }                      \
+Symbol getName() { return name; }                     \
+Symbol getReturnType() { return return_type; }        \
+Formals getFormals() { return formals; }              \
+void checkFormals(Formals, SymTab, Class_);
 
+#define attr_EXTRAS                                   \
+bool isMethod() { return false; }                     \
+Symbol getName() { return name; }                     \
+Symbol getReturnType() { return type_decl; }
 
 
 #define Formal_EXTRAS                              \
-virtual void dump_with_types(ostream&,int) = 0;
+virtual Symbol getName() = 0;                      \
+virtual Symbol getReturnType() = 0;
 
 
 #define formal_EXTRAS                           \
-void dump_with_types(ostream&,int);
+uint32_t encode_node(CompactAst&, uint32_t *);  \
+Symbol getName() { return name; }               \
+Symbol getReturnType() { return type_decl; }
 
 
+// typeChecker gives the type of a case branch or an expression from the
+// types of its subtrees (see TypeWalker in semant.cc).  typeCheckPre is
+// called before the subtrees are checked, and may return false to leave
+// them unchecked; typeCheckIn is called before subtree i > 0.
 #define Case_EXTRAS                             \
-virtual void dump_with_types(ostream& ,int) = 0;
+virtual bool typeCheckPre(SymTab, MAP, Class_) { return true; } \
+virtual Symbol typeChecker(SymTab, MAP, Class_, Symbol *) = 0;
 
 
 #define branch_EXTRAS                                   \
-void dump_with_types(ostream& ,int);
+uint32_t encode_node(CompactAst&, uint32_t *);          \
+bool typeCheckPre(SymTab, MAP, Class_);                 \
+Symbol typeChecker(SymTab, MAP, Class_, Symbol *);
 
 
 #define Expression_EXTRAS                    \
 Symbol type;                                 \
 Symbol get_type() { return type; }           \
 Expression set_type(Symbol s) { type = s; return this; } \
-virtual void dump_with_types(ostream&,int) = 0;  \
 void dump_type(ostream&, int);               \
-Expression_class() { type = (Symbol) NULL; }
+Expression_class() { type = (Symbol) NULL; } \
+virtual bool typeCheckPre(SymTab, MAP, Class_) { return true; } \
+virtual void typeCheckIn(SymTab, MAP, Class_, int, Symbol *) { } \
+virtual Symbol typeChecker(SymTab, MAP, Class_, Symbol *) = 0;
 
 #define Expression_SHARED_EXTRAS           \
-void dump_with_types(ostream&,int); 
+uint32_t encode_node(CompactAst&, uint32_t *); \
+Symbol typeChecker(SymTab, MAP, Class_, Symbol *);
+
+#define let_EXTRAS                         \
+bool typeCheckPre(SymTab, MAP, Class_);    \
+void typeCheckIn(SymTab, MAP, Class_, int, Symbol *);
+
+#define static_dispatch_EXTRAS             \
+void typeCheckIn(SymTab, MAP, Class_, int, Symbol *);
+
+#define cond_EXTRAS                        \
+bool typeCheckPre(SymTab, MAP, Class_);
+
+#define loop_EXTRAS                        \
+bool typeCheckPre(SymTab, MAP, Class_);
 
 #endif
\ No newline at end of file
@@ -1,19 +1,31 @@
 #include <stdio.h>
 #include "cool-tree.h"
+#include "compact-ast.h"
+#include "cool-parse.h"
 
-extern Program ast_root;      // root of the abstract syntax tree
+Program ast_root;             // root of the abstract syntax tree
 FILE *ast_file = stdin;       // we read the AST from standard input
-extern int ast_yyparse(void); // entry point to the AST parser
+extern Program read_text_ast(FILE *f); // the AST reader (ast-read.cc)
+extern int binary_ast;        // read and write the AST in binary form
 
 int cool_yydebug;     // not used, but needed to link with handle_flags
+int yy_flex_debug;    // likewise
+__thread YYSTYPE cool_yylval;  // not used, but needed to link with utilities
 char *curr_filename;
 
 void handle_flags(int argc, char *argv[]);
 
 int main(int argc, char *argv[]) {
   handle_flags(argc,argv);
-  ast_yyparse();
+  if (binary_ast)
+    ast_root = read_binary_ast(fileno(ast_file));
+  else
+    ast_root = read_text_ast(ast_file);
   ast_root->semant();
-  ast_root->dump_with_types(cout,0);
+  if (binary_ast)
+    ast_root->dump_binary(cout);
+  else
+    ast_root->dump_with_types(cout,0);
+  release_tree_nodes();
 }
 
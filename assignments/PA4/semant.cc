@@ -3,14 +3,11 @@
 #include <stdarg.h>
 #include "semant.h"
 #include "utilities.h"
-#include <map>
+#include "symbolmap.h"
 
 extern int semant_debug;
 extern char *curr_filename;
 
-typedef SymbolTable <Symbol, Symbol>* SymTab;
-typedef std::map<Symbol, Class_> MAP;
-
 //////////////////////////////////////////////////////////////////////
 //
 // Symbols
@@ -84,75 +81,76 @@ static void initialize_constants(void)
     val         = idtable.add_string("_val");
 }
 
-std::map<Symbol, Class_> classMap;
+SymbolMap<Class_> classMap;
 Class_ Object_class;
 ClassTable::ClassTable(Classes classes) : semant_errors(0) , error_stream(cerr) {
 
     install_basic_classes();
     int cMain = 0;  /* Check if main class exists */
-    for(int i = classes->first(); classes->more(i); i = classes->next(i))
+    for(Class_ c : *classes)
 	{
-		if(classes->nth(i)->getName() == Main) cMain = 1;
+		if(c->getName() == Main) cMain = 1;
 	}    
 	if(!cMain)	semant_error()<<"Class Main is not defined.\n";
 
     /* Traverse all the classes filling in the table that maps class names to class declarations.*/
-    for(int i = classes->first(); classes->more(i); i = classes->next(i))
+    for(Class_ c : *classes)
     {
-        Symbol s = classes->nth(i)->getName();
-        Symbol p = classes->nth(i)->getParent();
+        Symbol s = c->getName();
+        Symbol p = c->getParent();
         if(s == Object)
         {
-            semant_error(classes->nth(i))<<"Object can't be redefined\n";
+            semant_error(c)<<"Object can't be redefined\n";
         }
         else if(s == SELF_TYPE)
         {
-            semant_error(classes->nth(i))<<"Class name can not be SELF TYPE.\n";
+            semant_error(c)<<"Class name can not be SELF TYPE.\n";
         }
-        else if(classMap.find(s)->first==s)
+        else if(classMap.contains(s))
         {
-            semant_error(classes->nth(i))<<"Class "<<s<<" is redefined\n"; 
+            semant_error(c)<<"Class "<<s<<" is redefined\n"; 
         }
         else if(p == Bool ||  p == Str || p == Int || p == SELF_TYPE)
         {
-            semant_error(classes->nth(i))<<"Can't inherit from "<<p<<endl;
+            semant_error(c)<<"Can't inherit from "<<p<<endl;
         }
         else
-            classMap[s] = classes->nth(i);
+            classMap.set(s, c);
     }
 
     /* Checking the inherit graph if there's undefined class or inherit cycle */
     int flag=0; //if there's undefined class
     // Check undefined classes in the classMap
-    for(int i = classes->first(); classes->more(i); i = classes->next(i))
+    for(Class_ c : *classes)
     {
-        if(classMap.count(classes->nth(i)->getParent())==0)
+        if(!classMap.contains(c->getParent()))
         {
-            semant_error(classes->nth(i))<<"Class "<<classes->nth(i)->getParent()<<" is not defined\n";
+            semant_error(c)<<"Class "<<c->getParent()<<" is not defined\n";
             flag=0;
         }
     }
     // Check inherit cycle
-    std::map<Symbol, Symbol> cycle;
-    for(int i = classes->first(); classes->more(i) && flag; i = classes->next(i))
+    SymbolMap<Symbol> cycle;
+    for(Class_ c : *classes)
     {
-        if(classes->nth(i)->getParent() == Object)
+        if(!flag) break;
+        if(c->getParent() == Object)
         {
             cycle.clear();
         }
         else
         {
-            Class_ x = classes->nth(i);
+            Class_ x = c;
             while(1)
             {
                 Symbol s = x->getParent();
-                if( !classMap.empty() && (cycle.find(s)->first == s) && (x->getName() == cycle[cycle.find(s)->first])) 
+                if( !classMap.empty() && cycle.contains(s) && (x->getName() == cycle.lookup(s))) 
                 {
                     semant_error(x)<<"Error\n"; break;
                 }
                 if( x->getParent() == Object ) {break;}
-                cycle[x->getParent()] = x->getName();
-                x = classMap.find(x->getParent())->second;
+                cycle.set(x->getParent(), x->getName());
+                x = classMap.lookup(x->getParent());
             }
         } 
     } 
@@ -259,11 +257,11 @@ void ClassTable::install_basic_classes() {
 	       filename);
 
     //initial the classMap with defined Class
-    classMap[Object] = Object_class;
-    classMap[IO]     = IO_class;
-    classMap[Int]    = Int_class;
-    classMap[Bool]   = Bool_class;
-    classMap[Str]    = Str_class;
+    classMap.set(Object, Object_class);
+    classMap.set(IO,     IO_class);
+    classMap.set(Int,    Int_class);
+    classMap.set(Bool,   Bool_class);
+    classMap.set(Str,    Str_class);
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -317,6 +315,89 @@ void method_class::store()
 ClassTable *classtable;
 bool lub(Symbol sym1, Symbol sym2);
 
+//
+// Expressions are type checked by a tree_walker (see tree.h), so that a
+// deeply nested expression does not run out of C stack.  The typeChecker
+// of a node is called in the post hook, after those of its subtrees, and
+// is given their types: the walker keeps the types of the subtrees it
+// has checked on a stack (a list leaves those of its elements), and
+// replaces them with the type of their node.  typeCheckPre is called on
+// reaching a node, and the children are skipped if it returns false;
+// typeCheckIn is called between the children i-1 and i, with the types
+// of those before it.
+//
+class TypeWalker : public tree_walker {
+    SymTab attrTable;
+    MAP classMap;
+    Class_ curClasss;
+    Symbol *types;          // the types of the checked subtrees
+    int ntypes;
+    int *bases;             // where those of each node on the way down begin
+    int nbases;
+    int size;
+
+    void grow();
+public:
+    TypeWalker(SymTab a, MAP m, Class_ c) : attrTable(a), classMap(m), curClasss(c),
+        types(NULL), ntypes(0), bases(NULL), nbases(0), size(0) { }
+    ~TypeWalker() { delete [] types; delete [] bases; }
+    int pre(tree_node *t, int n);
+    void in(tree_node *t, int n, int i);
+    void post(tree_node *t, int n);
+    Symbol result() { return types[0]; }
+};
+
+void TypeWalker::grow()
+{
+    int new_size = size ? 2 * size : 64;
+    Symbol *t = new Symbol[new_size];
+    int *b = new int[new_size];
+    for(int i = 0; i < ntypes; i++) t[i] = types[i];
+    for(int i = 0; i < nbases; i++) b[i] = bases[i];
+    delete [] types;
+    delete [] bases;
+    types = t;
+    bases = b;
+    size = new_size;
+}
+
+int TypeWalker::pre(tree_node *t, int n)
+{
+    if(nbases == size) grow();
+    bases[nbases++] = ntypes;
+    Expression e = dynamic_cast<Expression>(t);
+    Case c = dynamic_cast<Case>(t);
+    if(e && !e->typeCheckPre(attrTable, classMap, curClasss)) skip_children();
+    if(c && !c->typeCheckPre(attrTable, classMap, curClasss)) skip_children();
+    return n;
+}
+
+void TypeWalker::in(tree_node *t, int n, int i)
+{
+    Expression e = dynamic_cast<Expression>(t);
+    if(e) e->typeCheckIn(attrTable, classMap, curClasss, i, types + bases[nbases-1]);
+}
+
+void TypeWalker::post(tree_node *t, int n)
+{
+    int base = bases[--nbases];
+    Expression e = dynamic_cast<Expression>(t);
+    Case c = dynamic_cast<Case>(t);
+    if(!e && !c) return;    // a list
+    Symbol type = e ? e->typeChecker(attrTable, classMap, curClasss, types + base)
+                    : c->typeChecker(attrTable, classMap, curClasss, types + base);
+    ntypes = base;
+    if(ntypes == size) grow();
+    types[ntypes++] = type;
+}
+
+Symbol checkExpr(Expression e, SymTab attrTable, MAP classMap, Class_ curClasss)
+{
+    TypeWalker w(attrTable, classMap, curClasss);
+    w.walk(e, 0);
+    return w.result();
+}
+
 //type checking
 Symbol method_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
 {
@@ -326,17 +407,17 @@ Symbol method_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClass
 		type = curClasss->getName();
 	}
 	else type = return_type;
-	Symbol return_expr = expr->typeChecker(attrTable, classMap, curClasss);
+	Symbol return_expr = checkExpr(expr, attrTable, classMap, curClasss);
 	return type;
 }
 
-Symbol int_const_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol int_const_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
     type = Int;
     return type;
 }
 
-Symbol object_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol object_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
 	if(this->name == self) {type = SELF_TYPE; }
 	else
@@ -347,25 +428,24 @@ Symbol object_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClass
     return type;
 }
 
-Symbol no_expr_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol no_expr_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
     type = No_type;
     return type;
 }
 
-Symbol isvoid_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol isvoid_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
-    e1->typeChecker(attrTable, classMap, curClasss) ;
     type = Bool;
     return type;
 }
 
-Symbol new__class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol new__class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
     if(type_name == SELF_TYPE) {type = SELF_TYPE; return type;}
     Symbol s = type_name;
     Symbol *a;
-    Symbol q = classMap.find(s)->first;
+    Symbol q = classMap.contains(s) ? s : NULL;
     if(q != NULL) {
     	type = q;
     }
@@ -375,28 +455,28 @@ Symbol new__class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss)
     return type;
 }
 
-Symbol string_const_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol string_const_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
     type = Str;
     return type;
 }
 
-Symbol bool_const_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol bool_const_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
     type = Bool;
     return type;
 }
 
-Symbol comp_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol comp_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
-    type = e1->typeChecker(attrTable, classMap, curClasss) ;
+    type = types[0];
     return type;
 }
 
-Symbol leq_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol leq_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
-    Symbol type1 = e1->typeChecker(attrTable, classMap, curClasss) ;
-    Symbol type2 = e2->typeChecker(attrTable, classMap, curClasss) ;
+    Symbol type1 = types[0];
+    Symbol type2 = types[1];
     if(type1 != Int || type2 != Int) 
     {
         classtable->semant_error(curClasss)<<"Both leq expresssions are not Int type.\n";
@@ -405,10 +485,10 @@ Symbol leq_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss)
     return type;
 }
 
-Symbol eq_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol eq_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
-    Symbol type1 = e1->typeChecker(attrTable, classMap, curClasss) ;
-    Symbol type2 = e2->typeChecker(attrTable, classMap, curClasss) ;
+    Symbol type1 = types[0];
+    Symbol type2 = types[1];
 	if((type1 == Int || type1 == Str || type1 == Bool) && type1 != type2)
 	{
 		classtable->semant_error(curClasss)<<"Both eq expressions are not Int type.\n";
@@ -417,10 +497,10 @@ Symbol eq_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss)
     return type;
 }
 
-Symbol lt_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol lt_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
-    Symbol type1 = e1->typeChecker(attrTable, classMap, curClasss) ;
-    Symbol type2 = e2->typeChecker(attrTable, classMap, curClasss) ;
+    Symbol type1 = types[0];
+    Symbol type2 = types[1];
     if(type1 != Int || type2 != Int) 
     {
         classtable->semant_error(curClasss)<<"Both lt expressions are not Int type.\n";
@@ -429,9 +509,9 @@ Symbol lt_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss)
     return type;
 }
 
-Symbol neg_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol neg_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
-    Symbol type1 = e1->typeChecker(attrTable, classMap, curClasss);
+    Symbol type1 = types[0];
     if(type1 != Int)
     {
         classtable->semant_error(curClasss)<<"Both neg expressions are not Int type.\n";
@@ -440,10 +520,10 @@ Symbol neg_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss)
     return type;
 }
 
-Symbol divide_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol divide_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
-    Symbol type1 = e1->typeChecker(attrTable, classMap, curClasss) ;
-    Symbol type2 = e2->typeChecker(attrTable, classMap, curClasss) ;
+    Symbol type1 = types[0];
+    Symbol type2 = types[1];
     if(type1 != Int || type2 != Int) 
     {
         classtable->semant_error(curClasss)<<"Both divide expressions are not Int type.\n";
@@ -452,10 +532,10 @@ Symbol divide_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClass
     return type;
 }
 
-Symbol mul_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol mul_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
-    Symbol type1 = e1->typeChecker(attrTable, classMap, curClasss) ;
-    Symbol type2 = e2->typeChecker(attrTable, classMap, curClasss) ;
+    Symbol type1 = types[0];
+    Symbol type2 = types[1];
     if(type1 != Int || type2 != Int) 
     {
         classtable->semant_error(curClasss)<<"Both mul expressions are not Int type.\n";
@@ -464,10 +544,10 @@ Symbol mul_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss)
     return type;
 }
 
-Symbol sub_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol sub_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
-    Symbol type1 = e1->typeChecker(attrTable, classMap, curClasss) ;
-    Symbol type2 = e2->typeChecker(attrTable, classMap, curClasss) ;
+    Symbol type1 = types[0];
+    Symbol type2 = types[1];
     if(type1 != Int || type2 != Int) 
     {
         classtable->semant_error(curClasss)<<"Both sub expressions are not Int type.\n";
@@ -476,10 +556,10 @@ Symbol sub_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss)
     return type;
 }
 
-Symbol plus_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol plus_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
-    Symbol type1 = e1->typeChecker(attrTable, classMap, curClasss) ;
-    Symbol type2 = e2->typeChecker(attrTable, classMap, curClasss) ;
+    Symbol type1 = types[0];
+    Symbol type2 = types[1];
     if(type1 != Int || type2 != Int) 
     {
         classtable->semant_error(curClasss)<<"Both plus expressions are not Int type.\n";
@@ -488,124 +568,132 @@ Symbol plus_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss)
     return type;
 }
 
-Symbol let_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+bool let_class::typeCheckPre(SymTab attrTable, MAP classMap, Class_ curClasss) 
 {
 	if(identifier == self)
 	{
 		classtable->semant_error(curClasss)<<"No self binding in LET allowed.\n";
+		return false;
 	}
-	else 
+	return true;
+}
+
+// between the init and the body: the init has been checked (types[0])
+void let_class::typeCheckIn(SymTab attrTable, MAP classMap, Class_ curClasss, int i, Symbol *types) 
+{
+	Symbol type1;
+	if(this->init)
 	{
-		Symbol type1;
-		if(this->init)
+		if(type_decl == SELF_TYPE)
+			type1 = curClasss->getName();
+		else type1 = type_decl;
+		Symbol typeExpr = types[0];
+		if(!lub(type1, typeExpr))
 		{
-			if(type_decl == SELF_TYPE)
-				type1 = curClasss->getName();
-			else type1 = type_decl;
-			Symbol typeExpr = init->typeChecker(attrTable, classMap, curClasss);
-			if(!lub(type1, typeExpr))
-			{
-				classtable->semant_error(curClasss)<<"Wrong let expression.";
-			}
-			attrTable->enterscope();
-			attrTable->addid(identifier, new Symbol(type_decl));
+			classtable->semant_error(curClasss)<<"Wrong let expression.";
 		}
-		else 
-		{
-			if(type_decl == SELF_TYPE)
-				type1 = curClasss->getName();
-			else type1 = type_decl;
-			attrTable->enterscope();
-			attrTable->addid(identifier, new Symbol(type_decl));
+		attrTable->enterscope();
+		attrTable->addid(identifier, new Symbol(type_decl));
+	}
+	else 
+	{
+		if(type_decl == SELF_TYPE)
+			type1 = curClasss->getName();
+		else type1 = type_decl;
+		attrTable->enterscope();
+		attrTable->addid(identifier, new Symbol(type_decl));
 
-		}
-		type = body->typeChecker(attrTable, classMap, curClasss);
 	}
+}
+
+Symbol let_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
+{
+	if(identifier != self)
+		type = types[1];
 	return type;	
 }
 
-Symbol block_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol block_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
-    for(int i = body->first(); body->more(i); i = body->next(i))
-    type = body->nth(i)->typeChecker(attrTable, classMap, curClasss) ;
+    for(int i = 0; i < body->len(); i++)
+    type = types[i];
     return type;
 }
 
-Symbol typcase_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol typcase_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
-    expr->typeChecker(attrTable, classMap, curClasss);
-    for(int i = cases->first(); cases->more(i); i = cases->next(i))
-    {
-    	Case c = cases->nth(i);
-    	c->typeChecker(attrTable, classMap, curClasss);
-    }
     return Int;
 }
 
-Symbol branch_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+bool branch_class::typeCheckPre(SymTab attrTable, MAP classMap, Class_ curClasss) 
 {
 	attrTable->enterscope();
     attrTable->addid(this->name, new Symbol(type_decl));
-    Symbol t = this->expr->typeChecker(attrTable, classMap, curClasss);
+    return true;
+}
+
+Symbol branch_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
+{
+    Symbol t = types[0];
     attrTable->exitscope();
     return t;
 }
 
-Symbol loop_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+// the predicate and body of loops and conditionals are not checked
+bool loop_class::typeCheckPre(SymTab attrTable, MAP classMap, Class_ curClasss) 
+{
+    return false;
+}
+
+Symbol loop_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
     type = Int;
     return type;
 }
 
-Symbol cond_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+bool cond_class::typeCheckPre(SymTab attrTable, MAP classMap, Class_ curClasss) 
+{
+    return false;
+}
+
+Symbol cond_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
     type = Int;
     return type;
 }
 
-Symbol dispatch_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol dispatch_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
     if(name == ::copy || name == out_int || name == out_string)
 	{
-		type = expr->typeChecker(attrTable, classMap, curClasss);
-		for(int i = actual->first(); actual->more(i); i = actual->next(i))
-	    {
-	    	actual->nth(i)->typeChecker(attrTable, classMap, curClasss); 
-	    }
+		type = types[0];
 		return type;
 	}
 
     Symbol type1;
-    type1 = expr->typeChecker(attrTable, classMap, curClasss); 
+    type1 = types[0];
     if(type1 == SELF_TYPE) type1 = curClasss->getName();
-    int i;
-    for(i = actual->first(); actual->more(i); i = actual->next(i))
-    {
-    	actual->nth(i)->typeChecker(attrTable, classMap, curClasss); 
-    }
     Symbol *type_name = methodTable->lookup(this->name);
     if(*type_name == SELF_TYPE) *type_name = type1;
     type = *type_name;
     return type;
 }
 
-Symbol static_dispatch_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+// between the expression and the actuals
+void static_dispatch_class::typeCheckIn(SymTab attrTable, MAP classMap, Class_ curClasss, int i, Symbol *types) 
 {
-	Symbol type0 = expr->typeChecker(attrTable, classMap, curClasss); 
+	Symbol type0 = types[0];
 	if(!lub(type_name, type0)) 
 	{
 		classtable->semant_error(curClasss)<<"Not a valid type in static dispacth.\n";
 	}
-    
+}
 
+Symbol static_dispatch_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
+{
     Symbol type1;
-    type1 = expr->typeChecker(attrTable, classMap, curClasss); 
+    type1 = types[0];
     if(type1 == SELF_TYPE) type1 = curClasss->getName();
-    int i;
-    for(i = actual->first(); actual->more(i); i = actual->next(i))
-    {
-    	actual->nth(i)->typeChecker(attrTable, classMap, curClasss); 
-    }
     Symbol *type_name = methodTable->lookup(this->name);
     if(*type_name == SELF_TYPE) *type_name = type1;
     type = *type_name;
@@ -613,12 +701,12 @@ Symbol static_dispatch_class::typeChecker(SymTab attrTable, MAP classMap, Class_
     return type;
 }
 
-Symbol assign_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss) 
+Symbol assign_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss, Symbol *types) 
 {
     Symbol *varType;
     varType = new Symbol();
     varType = attrTable->lookup(name);
-    Symbol exprType = expr->typeChecker(attrTable, classMap, curClasss);
+    Symbol exprType = types[0];
 	if(name == self) classtable->semant_error(curClasss)<<"Self type.\n";
 	else if(*varType == exprType) 
 	{
@@ -637,50 +725,50 @@ Symbol assign_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClass
 
 Symbol attr_class::typeChecker(SymTab attrTable, MAP classMap, Class_ curClasss)
 {
-	Symbol initType = init->typeChecker(attrTable, classMap, curClasss);
+	Symbol initType = checkExpr(init, attrTable, classMap, curClasss);
 	if(initType == SELF_TYPE) ;
 	else if(initType != No_type && lub(type_decl, initType)) {}
-	else if(!classMap.find(initType)->second) classtable->semant_error(curClasss)<<"Undefined.\n";
+	else if(!classMap.lookup(initType)) classtable->semant_error(curClasss)<<"Undefined.\n";
 	return type_decl;
 }
 
 void method_class::checkFormals(Formals formals, SymTab attrTable, Class_ curClasss)
 {
     attrTable->enterscope();
-    for(int i = formals->first(); formals->more(i); i = formals->next(i))
+    for(Formal f : *formals)
     {
-		if(attrTable->lookup(formals->nth(i)->getName()) && formals->nth(i)->getReturnType())
+		if(attrTable->lookup(f->getName()) && f->getReturnType())
 		{
 			classtable->semant_error(curClasss)<<"Duplicate formal parameter.\n";
 		}
-		 if(formals->nth(i)->getName() == self)
+		 if(f->getName() == self)
 		{
 			classtable->semant_error(curClasss)<<"Formal parameter can't include self.\n";
 		}
-		else if(formals->nth(i)->getReturnType() == SELF_TYPE)
+		else if(f->getReturnType() == SELF_TYPE)
 		{         
-			classtable->semant_error(curClasss)<<"Formal parameter "<<formals->nth(i)->getName()<<" can't be SELF_TYPE.\n";		
+			classtable->semant_error(curClasss)<<"Formal parameter "<<f->getName()<<" can't be SELF_TYPE.\n";		
 		}
-		attrTable->addid(formals->nth(i)->getName(), new Symbol(formals->nth(i)->getReturnType()));
+		attrTable->addid(f->getName(), new Symbol(f->getReturnType()));
     }
 }
 
 void TypeCheck(Classes classes)
 {
 	methodTable->enterscope();
-	for(int i = classes->first(); classes->more(i); i = classes->next(i)) {
+	for(Class_ c : *classes) {
         int flag=0;
         attrTable->enterscope();
-        Class_ curClass = classes->nth(i);
+        Class_ curClass = c;
         while(curClass!=Object_class) {
         	Features classFeatures = curClass->getFeatures();
-            for(int j = classFeatures->first(); classFeatures->more(j); j = classFeatures->next(j)) {
-                if(classFeatures->nth(j)->isMethod()) {
-                    Feature curMethod = classFeatures->nth(j);                    
+            for(Feature f : *classFeatures) {
+                if(f->isMethod()) {
+                    Feature curMethod = f;
                     curMethod->store();
                 }
-                else if(!classFeatures->nth(j)->isMethod() && !attrTable->probe(classFeatures->nth(j)->getName())) {
-                	Feature curAttribute = classFeatures->nth(j);
+                else if(!f->isMethod() && !attrTable->probe(f->getName())) {
+                	Feature curAttribute = f;
                     if(curAttribute->getName() == self) {
                         classtable->semant_error(curClass)<<"Attribute can't be self\n";
                         return;
@@ -695,7 +783,7 @@ void TypeCheck(Classes classes)
             	flag=1;
             	break;
             }
-            curClass = (classMap.find(curClass->getParent()))->second;
+            curClass = classMap.lookup(curClass->getParent());
         }
         
     }
@@ -703,11 +791,9 @@ void TypeCheck(Classes classes)
     methodTable->addid(in_int, new Symbol(Int));
     methodTable->addid(length, new Symbol(Int));
     methodTable->addid(cool_abort, new Symbol(Object));
-    for(int i = classes->first(); classes->more(i); i = classes->next(i)) {
-    	Class_ curClass = classes->nth(i);
+    for(Class_ curClass : *classes) {
     	Features classFeatures = curClass->getFeatures();
-    	for(int j = classFeatures->first(); classFeatures->more(j); j = classFeatures->next(j)) {
-    		Feature currFeature = classFeatures->nth(j);
+    	for(Feature currFeature : *classFeatures) {
     		if(currFeature->isMethod()) {currFeature->checkFormals(currFeature->getFormals(), attrTable, curClass); }
     		currFeature->typeChecker(attrTable,classMap,curClass);
     		if(currFeature->isMethod()){attrTable->exitscope();}
@@ -721,10 +807,10 @@ void TypeCheck(Classes classes)
 bool lub(Symbol sym1, Symbol sym2) {
     if(sym1 == sym2) return true;
     while(sym2 != Object) {
-	    if(sym1 == (classMap.find(sym2)->second)->getParent()) {
+	    if(sym1 == classMap.lookup(sym2)->getParent()) {
 	        return true;
 	    }
-	    sym2 = (classMap.find(sym2)->second)->getParent();
+	    sym2 = classMap.lookup(sym2)->getParent();
 	}
     return false;
 }
@@ -413,12 +413,12 @@ void StringEntry::code_def(ostream& s, int stringclasstag)
 //
 // StrTable::code_string
 // Generate a string object definition for every string constant in the 
-// stringtable.
+// stringtable.  Constants are emitted newest first, by index.
 //
 void StrTable::code_string_table(ostream& s, int stringclasstag)
 {  
-  for (List<StringEntry> *l = tbl; l; l = l->tl())
-    l->hd()->code_def(s,stringclasstag);
+  for (int i = index - 1; i >= 0; i--)
+    lookup(i)->code_def(s,stringclasstag);
 }
 
 //
@@ -458,8 +458,8 @@ void IntEntry::code_def(ostream &s, int intclasstag)
 //
 void IntTable::code_string_table(ostream &s, int intclasstag)
 {
-  for (List<IntEntry> *l = tbl; l; l = l->tl())
-    l->hd()->code_def(s,intclasstag);
+  for (int i = index - 1; i >= 0; i--)
+    lookup(i)->code_def(s,intclasstag);
 }
 
 
@@ -777,8 +777,8 @@ void CgenClassTable::install_class(CgenNodeP nd)
 
 void CgenClassTable::install_classes(Classes cs)
 {
-  for(int i = cs->first(); cs->more(i); i = cs->next(i))
-    install_class(new CgenNode(cs->nth(i),NotBasic,this));
+  for (Class_ c : *cs)
+    install_class(new CgenNode(c,NotBasic,this));
 }
 
 //
@@ -2,7 +2,7 @@
 #include <stdio.h>
 #include "emit.h"
 #include "cool-tree.h"
-#include "symtab.h"
+#include "symbolmap.h"
 
 enum Basicness     {Basic, NotBasic};
 #define TRUE 1
@@ -14,7 +14,7 @@ typedef CgenClassTable *CgenClassTableP;
 class CgenNode;
 typedef CgenNode *CgenNodeP;
 
-class CgenClassTable : public SymbolTable<Symbol,CgenNode> {
+class CgenClassTable : public ScopedSymbolMap<CgenNodeP> {
 private:
    List<CgenNode> *nds;
    ostream& str;
@@ -35,7 +35,7 @@ private:
 // The following creates an inheritance graph from
 // a list of classes.  The graph is implemented as
 // a tree of `CgenNode', and class names are placed
-// in the base class symbol table.
+// in the base class symbol map.
 
    void install_basic_classes();
    void install_class(CgenNodeP nd);
@@ -19,8 +19,7 @@ typedef class Program_class *Program;
 
 class Program_class : public tree_node {
 public:
-   tree_node *copy()		 { return copy_Program(); }
-   virtual Program copy_Program() = 0;
+   Program copy_Program()	 { return (Program) copy(); }
 
 #ifdef Program_EXTRAS
    Program_EXTRAS
@@ -33,8 +32,7 @@ typedef class Class__class *Class_;
 
 class Class__class : public tree_node {
 public:
-   tree_node *copy()		 { return copy_Class_(); }
-   virtual Class_ copy_Class_() = 0;
+   Class_ copy_Class_()	 { return (Class_) copy(); }
 
 #ifdef Class__EXTRAS
    Class__EXTRAS
@@ -47,8 +45,7 @@ typedef class Feature_class *Feature;
 
 class Feature_class : public tree_node {
 public:
-   tree_node *copy()		 { return copy_Feature(); }
-   virtual Feature copy_Feature() = 0;
+   Feature copy_Feature()	 { return (Feature) copy(); }
 
 #ifdef Feature_EXTRAS
    Feature_EXTRAS
@@ -61,8 +58,7 @@ typedef class Formal_class *Formal;
 
 class Formal_class : public tree_node {
 public:
-   tree_node *copy()		 { return copy_Formal(); }
-   virtual Formal copy_Formal() = 0;
+   Formal copy_Formal()	 { return (Formal) copy(); }
 
 #ifdef Formal_EXTRAS
    Formal_EXTRAS
@@ -75,8 +71,7 @@ typedef class Expression_class *Expression;
 
 class Expression_class : public tree_node {
 public:
-   tree_node *copy()		 { return copy_Expression(); }
-   virtual Expression copy_Expression() = 0;
+   Expression copy_Expression()	 { return (Expression) copy(); }
 
 #ifdef Expression_EXTRAS
    Expression_EXTRAS
@@ -89,8 +84,7 @@ typedef class Case_class *Case;
 
 class Case_class : public tree_node {
 public:
-   tree_node *copy()		 { return copy_Case(); }
-   virtual Case copy_Case() = 0;
+   Case copy_Case()	 { return (Case) copy(); }
 
 #ifdef Case_EXTRAS
    Case_EXTRAS
@@ -133,8 +127,11 @@ public:
    program_class(Classes a1) {
       classes = a1;
    }
-   Program copy_Program();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
 
 #ifdef Program_SHARED_EXTRAS
    Program_SHARED_EXTRAS
@@ -159,8 +156,13 @@ public:
       features = a3;
       filename = a4;
    }
-   Class_ copy_Class_();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   void dump_post(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Class__SHARED_EXTRAS
    Class__SHARED_EXTRAS
@@ -185,8 +187,13 @@ public:
       return_type = a3;
       expr = a4;
    }
-   Feature copy_Feature();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   void dump_in(ostream& stream, int n, int i);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_in(ostream& stream, int n, int i);
 
 #ifdef Feature_SHARED_EXTRAS
    Feature_SHARED_EXTRAS
@@ -209,8 +216,11 @@ public:
       type_decl = a2;
       init = a3;
    }
-   Feature copy_Feature();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
 
 #ifdef Feature_SHARED_EXTRAS
    Feature_SHARED_EXTRAS
@@ -231,8 +241,9 @@ public:
       name = a1;
       type_decl = a2;
    }
-   Formal copy_Formal();
-   void dump(ostream& stream, int n);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
 
 #ifdef Formal_SHARED_EXTRAS
    Formal_SHARED_EXTRAS
@@ -255,8 +266,11 @@ public:
       type_decl = a2;
       expr = a3;
    }
-   Case copy_Case();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
 
 #ifdef Case_SHARED_EXTRAS
    Case_SHARED_EXTRAS
@@ -277,8 +291,12 @@ public:
       name = a1;
       expr = a2;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -303,8 +321,14 @@ public:
       name = a3;
       actual = a4;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   void dump_in(ostream& stream, int n, int i);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_in(ostream& stream, int n, int i);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -327,8 +351,14 @@ public:
       name = a2;
       actual = a3;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   void dump_in(ostream& stream, int n, int i);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_in(ostream& stream, int n, int i);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -351,8 +381,12 @@ public:
       then_exp = a2;
       else_exp = a3;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -373,8 +407,12 @@ public:
       pred = a1;
       body = a2;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -395,8 +433,12 @@ public:
       expr = a1;
       cases = a2;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -415,8 +457,12 @@ public:
    block_class(Expressions a1) {
       body = a1;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -441,8 +487,12 @@ public:
       init = a3;
       body = a4;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -463,8 +513,12 @@ public:
       e1 = a1;
       e2 = a2;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -485,8 +539,12 @@ public:
       e1 = a1;
       e2 = a2;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -507,8 +565,12 @@ public:
       e1 = a1;
       e2 = a2;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -529,8 +591,12 @@ public:
       e1 = a1;
       e2 = a2;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -549,8 +615,12 @@ public:
    neg_class(Expression a1) {
       e1 = a1;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -571,8 +641,12 @@ public:
       e1 = a1;
       e2 = a2;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -593,8 +667,12 @@ public:
       e1 = a1;
       e2 = a2;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -615,8 +693,12 @@ public:
       e1 = a1;
       e2 = a2;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -635,8 +717,12 @@ public:
    comp_class(Expression a1) {
       e1 = a1;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -655,8 +741,10 @@ public:
    int_const_class(Symbol a1) {
       token = a1;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -675,8 +763,10 @@ public:
    bool_const_class(Boolean a1) {
       val = a1;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -695,8 +785,10 @@ public:
    string_const_class(Symbol a1) {
       token = a1;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -715,8 +807,10 @@ public:
    new__class(Symbol a1) {
       type_name = a1;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -735,8 +829,12 @@ public:
    isvoid_class(Expression a1) {
       e1 = a1;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   int children();
+   tree_node *child(int i);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -753,8 +851,10 @@ public:
 public:
    no_expr_class() {
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -773,8 +873,10 @@ public:
    object_class(Symbol a1) {
       name = a1;
    }
-   Expression copy_Expression();
-   void dump(ostream& stream, int n);
+   tree_node *copy_node(tree_node **kids);
+   int dump_pre(ostream& stream, int n);
+   int dump_with_types_pre(ostream& stream, int n);
+   void dump_with_types_post(ostream& stream, int n);
 
 #ifdef Expression_SHARED_EXTRAS
    Expression_SHARED_EXTRAS
@@ -0,0 +1,577 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  coolc.cc
+//
+//  The whole compiler in one process.  mycoolc runs
+//
+//      lexer | parser | semant | cgen
+//
+//  as four processes that pass the tokens and the AST along as text.
+//  Here the lexer (cool-lex.cc, from cool.flex) is linked straight into
+//  the parser (cool-parse.cc, from cool.y), which pulls tokens from it
+//  through cool_yylex, and the tree the parser builds is handed to
+//  semant and cgen as it is.  The flags are those of handle_flags.cc.
+//
+//  Each input file is parsed on its own, with curr_filename and
+//  curr_lineno set for it, and the classes of all the files are
+//  gathered, in command line order, into one program.
+//
+//  With -P the lexer runs on a thread of its own, and passes the tokens
+//  to the parser through a TokenQueue (see token-queue.h), so that the
+//  scanning of a file goes on while the parser works through the
+//  tokens already scanned.
+//
+//  With -j each file is lexed and parsed on a thread of its own, all at
+//  once, and the classes are gathered as before when the threads are
+//  done.  The output is that of coolc without -j: see
+//  parse_files_in_parallel.
+//
+//  With -J threads, the classes of each file are parsed on that many
+//  threads at once, and put together in source order; again the output
+//  is that of coolc without -J: see parse_classes.  -J takes the place
+//  of -P, and -j of -J.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <unistd.h>
+#include <string.h>
+#include <pthread.h>
+#include <sstream>
+#include "cool-io.h"  //includes iostream
+#include "cool-tree.h"
+#include "cool-parse.h"
+#include "cgen_gc.h"
+#include "token-queue.h"
+
+extern int optind;            // for option processing
+extern char *out_filename;    // name of output assembly
+
+//
+// cool_scan_file (see cool.flex) maps each input file into memory, or
+// reads it whole through fin, and the lexer scans it there; the tokens
+// the parser holds point into it until cool_scan_end.  cool_scan_token
+// returns each token with its value and line, which cool_yylex (below)
+// hands on to the parser in cool_yylval and curr_lineno.  curr_lineno
+// is defined by the parser, whose token locations it is (see cool.y).
+//
+FILE *fin;
+extern __thread int curr_lineno;
+__thread char *curr_filename = "<stdin>";
+
+extern int cool_scan_file(char *name);
+extern void cool_scan_end();
+extern int cool_scan_token(YYSTYPE *lval, int *lineno);
+extern int cool_scan_threadsafe;  // may several threads scan at once?
+
+//
+// The state of a parse is one per thread (see cool.y).
+//
+extern __thread Classes parse_results; // the classes of the last file parsed
+extern __thread Program ast_root;      // the program of the last file parsed
+extern __thread int omerrs;            // a count of lex and parse errors
+extern __thread ostream *parse_errors; // where the parser reports errors
+extern __thread SymbolCaches *symbol_caches;
+extern __thread int node_lineno;
+
+extern int cool_yyparse();
+extern int pipeline_parse;    // -P: lex on a thread of its own
+extern int parallel_parse;    // -j: lex and parse each file on a thread of its own
+extern int class_threads;     // -J: parse the classes of a file on this many threads
+void handle_flags(int argc, char *argv[]);
+
+//
+// With -P, the lexer thread scans the current file into the queue, up to
+// and including its end (token 0), and the parser takes the tokens from
+// there.  The scanner touches nothing of the parser's meanwhile: the
+// values of the tokens point into the input, or at constant messages.
+//
+// The direct-coded scanner keeps its state one per thread (see
+// cool-scan.cc), so the lexer thread opens the file as well, and closes
+// it once the parser is done with the tokens: it waits on parse_lock,
+// which the parser holds until then.
+//
+static TokenQueue token_queue;
+static bool queue_at_end;     // the parser has taken the end of the file
+static int lexer_opened;      // 0 until the lexer has tried, then 1, or -1
+static pthread_t lexer;
+static pthread_mutex_t parse_lock = PTHREAD_MUTEX_INITIALIZER;
+
+//
+// The tokens of a whole file, scanned before it is parsed (see
+// parse_file_thread), or of a part of one (see parse_classes).  The
+// parser is given the ntokens tokens, and then `end', a token 0, as
+// often as it asks.
+//
+struct TokenBuffer {
+  QueuedToken *token;
+  int ntokens;
+  int size;
+  int next;                   // the next token for the parser
+  QueuedToken end;
+};
+static __thread TokenBuffer *token_buffer;
+
+static void *lex_file(void *name)
+{
+  YYSTYPE lval;
+  int lineno, token;
+
+  if (!cool_scan_file((char *) name)) {
+    __atomic_store_n(&lexer_opened, -1, __ATOMIC_RELEASE);
+    return NULL;
+  }
+  __atomic_store_n(&lexer_opened, 1, __ATOMIC_RELEASE);
+  do {
+    token = cool_scan_token(&lval, &lineno);
+    token_queue.put(token, lineno, &lval);
+  } while (token != 0);
+  pthread_mutex_lock(&parse_lock);
+  cool_scan_end();
+  pthread_mutex_unlock(&parse_lock);
+  return NULL;
+}
+
+int cool_yylex()
+{
+  if (token_buffer) {
+    TokenBuffer *b = token_buffer;
+    QueuedToken &q = b->next < b->ntokens ? b->token[b->next++] : b->end;
+    curr_lineno = q.lineno;
+    cool_yylval = q.lval;
+    return q.token;
+  }
+  if (!pipeline_parse)
+    return cool_scan_token(&cool_yylval, &curr_lineno);
+  int token = token_queue.get(&curr_lineno, &cool_yylval);
+  if (token == 0)
+    queue_at_end = true;
+  return token;
+}
+
+// open_file(name) makes the file the input, and returns 0 if it cannot
+// be opened; with -P, it starts the lexer thread on it.
+static int open_file(char *name)
+{
+  if (!pipeline_parse)
+    return cool_scan_file(name);
+
+  queue_at_end = false;
+  lexer_opened = 0;
+  pthread_mutex_lock(&parse_lock);
+  if (pthread_create(&lexer, NULL, lex_file, name) != 0) {
+    cerr << "Cannot start the lexer thread\n";
+    exit(1);
+  }
+  while (__atomic_load_n(&lexer_opened, __ATOMIC_ACQUIRE) == 0)
+    sched_yield();
+  if (lexer_opened < 0) {
+    pthread_mutex_unlock(&parse_lock);
+    pthread_join(lexer, NULL);
+    return 0;
+  }
+  return 1;
+}
+
+static void parse_classes();
+
+static void parse_file()
+{
+  if (class_threads > 1) {
+    parse_classes();
+    cool_scan_end();
+    return;
+  }
+  cool_yyparse();
+  if (!pipeline_parse) {
+    cool_scan_end();
+    return;
+  }
+
+  // The parser may give up before the end of the file; the lexer does
+  // not, so take the rest of its tokens.
+  while (!queue_at_end) {
+    YYSTYPE lval;
+    int lineno;
+    queue_at_end = token_queue.get(&lineno, &lval) == 0;
+  }
+  pthread_mutex_unlock(&parse_lock);
+  pthread_join(lexer, NULL);
+}
+
+//
+// With -j, each file is parsed by parse_file_thread on a thread of its
+// own.  The thread builds the tree in an arena of its own, enters strings
+// into the tables through caches of its own (see StringTableCache in
+// stringtab.h), and keeps its error messages, rather than print them.
+//
+struct FileParse {
+  char *name;
+  pthread_t thread;
+  bool opened;                // could the file be opened?
+  int errors;                 // omerrs, at the end of the parse
+  Program ast_root;
+  Classes parse_results;
+  std::ostringstream messages;  // the error messages, one to a line
+  Arena nodes;                // the tree nodes of the file
+  SymbolCaches symbols;
+};
+
+//
+// The flex scanner keeps its state in static variables, so that only one
+// thread at a time may scan with it.  A thread then scans its whole
+// file into a TokenBuffer while it holds scan_lock, and parses once it
+// has let go.  The spans of the tokens are copied out of the input,
+// which is released as soon as it has been scanned.
+//
+static pthread_mutex_t scan_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// scan the input into b, copying the spans of the tokens into texts,
+// unless it is NULL
+static void scan_to_buffer(TokenBuffer *b, Arena *texts)
+{
+  int token;
+
+  b->size = 1024;
+  b->token = new QueuedToken[b->size];
+  b->ntokens = b->next = 0;
+  do {
+    if (b->ntokens == b->size) {
+      QueuedToken *old = b->token;
+      b->token = new QueuedToken[2 * b->size];
+      memcpy(b->token, old, b->size * sizeof(QueuedToken));
+      delete [] old;
+      b->size *= 2;
+    }
+    QueuedToken &q = b->token[b->ntokens++];
+    token = q.token = cool_scan_token(&q.lval, &q.lineno);
+    if (texts && (token == TYPEID || token == OBJECTID ||
+		  token == INT_CONST || token == STR_CONST))
+      q.lval.span.text = texts->copy_string(q.lval.span.text, q.lval.span.len);
+  } while (token != 0);
+  b->end = b->token[--b->ntokens];
+}
+
+static void *parse_file_thread(void *arg)
+{
+  FileParse *f = (FileParse *) arg;
+  TokenBuffer buffer;
+  Arena texts;
+
+  curr_filename = f->name;
+  curr_lineno = 1;
+  node_pool = &f->nodes;
+  symbol_caches = &f->symbols;
+  parse_errors = &f->messages;
+
+  if (cool_scan_threadsafe)
+    f->opened = cool_scan_file(f->name);
+  else {
+    pthread_mutex_lock(&scan_lock);
+    f->opened = cool_scan_file(f->name);
+    if (f->opened) {
+      scan_to_buffer(&buffer, &texts);
+      cool_scan_end();
+      token_buffer = &buffer;
+    }
+    pthread_mutex_unlock(&scan_lock);
+  }
+  if (!f->opened)
+    return NULL;
+
+  cool_yyparse();
+  if (token_buffer) {
+    delete [] buffer.token;
+    texts.clear();
+  } else
+    cool_scan_end();
+  f->errors = omerrs;
+  f->ast_root = ast_root;
+  f->parse_results = parse_results;
+  return NULL;
+}
+
+//
+// The threads' errors are printed once they are all done, file by file,
+// in command line order, and as the parser would have printed them,
+// giving up after 50.  If a file could not be opened, that is reported
+// in its turn.
+//
+static void report_errors(FileParse *f)
+{
+  std::string text = f->messages.str();
+  size_t start = 0, nl;
+
+  while ((nl = text.find('\n', start)) != std::string::npos) {
+    cerr << text.substr(start, nl + 1 - start) << std::flush;
+    start = nl + 1;
+    if (++omerrs > 50) {
+      fprintf(stdout, "More than 50 errors\n");
+      exit(1);
+    }
+  }
+  if (!f->opened) {
+    cerr << "Could not open input file " << f->name << endl;
+    exit(1);
+  }
+}
+
+//
+// The threads give the strings they enter indices in the order they get
+// to them.  Afterwards the tables are renumbered, file by file, in the
+// order of each file's cache, which is the order in which the strings
+// were first entered by the file's parse: the indices are then those
+// that parsing the files one after another would have given.
+//
+static void parse_files_in_parallel(int nfiles, char **names,
+				    Classes *classes, int *program_line)
+{
+  FileParse *file = new FileParse[nfiles];
+  int next_id = idtable.size();
+  int next_string = stringtable.size();
+  int next_int = inttable.size();
+
+  for (int i = 0; i < nfiles; i++) {
+    file[i].name = names[i];
+    if (pthread_create(&file[i].thread, NULL, parse_file_thread, &file[i]) != 0) {
+      cerr << "Cannot start a parser thread\n";
+      exit(1);
+    }
+  }
+  for (int i = 0; i < nfiles; i++)
+    pthread_join(file[i].thread, NULL);
+
+  for (int i = 0; i < nfiles; i++) {
+    next_id = idtable.renumber(next_id, file[i].symbols.ids);
+    next_string = stringtable.renumber(next_string, file[i].symbols.strings);
+    next_int = inttable.renumber(next_int, file[i].symbols.ints);
+  }
+
+  for (int i = 0; i < nfiles; i++) {
+    FileParse *f = &file[i];
+    report_errors(f);
+    if (f->errors == 0 && f->ast_root != NULL) {
+      if (*classes == NULL) {
+	*program_line = f->ast_root->get_line_number();
+	*classes = f->parse_results;
+      } else
+	*classes = append_Classes(*classes, f->parse_results);
+    }
+  }
+}
+
+//
+// With -J, the file is scanned whole into a TokenBuffer, and cut before
+// each CLASS token into pieces.  A class cannot hold another, so each
+// piece is a class, but for any tokens before the first.  The threads
+// take the pieces in turn and parse each on its own, as a program of
+// one class, building its nodes in the thread's arena and entering its
+// strings through caches of the piece's own.  The classes are then put
+// together in source order, and the tables renumbered piece by piece,
+// as in parse_files_in_parallel, so that the program is the one that
+// parsing the whole file gives.
+//
+// That holds as long as there are no errors: the parse of the whole
+// file starts each class in the state it is in after a whole class,
+// which is where the parse of a piece starts too, and goes through it
+// as the parse of the piece does.  After an error the parser recovers
+// by skipping tokens, perhaps on into the next class, so the pieces
+// from the first one with an error on are parsed again, as one, on the
+// main thread, and the errors reported are those of that parse.  The
+// errors of the threads are not kept.
+//
+struct ClassParse {
+  int start;                  // the first token of the piece
+  int ntokens;
+  int errors;                 // omerrs, at the end of the parse
+  Program ast_root;
+  Classes parse_results;
+  SymbolCaches symbols;
+};
+
+struct ClassParser {
+  pthread_t thread;
+  Arena nodes;                // the tree nodes of the classes it parses
+};
+
+static char *class_tokens_file;     // the file being parsed
+static TokenBuffer class_tokens;    // its tokens
+static ClassParse *class_parse;     // its pieces
+static int nclass_parses;
+static int next_class_parse;        // the next piece for a thread to take
+
+// parse the ntokens tokens of the file from start on, and then an end
+// of file
+static void parse_tokens(int start, int ntokens)
+{
+  TokenBuffer piece;
+  int after = start + ntokens;
+
+  piece.token = class_tokens.token + start;
+  piece.ntokens = ntokens;
+  piece.next = 0;
+  piece.end = after < class_tokens.ntokens ? class_tokens.token[after]
+					   : class_tokens.end;
+  piece.end.token = 0;
+  token_buffer = &piece;
+  ast_root = NULL;
+  cool_yyparse();
+  token_buffer = NULL;
+}
+
+static void *parse_classes_thread(void *arg)
+{
+  ClassParser *p = (ClassParser *) arg;
+  std::ostringstream messages;
+  int i;
+
+  curr_filename = class_tokens_file;
+  node_pool = &p->nodes;
+  parse_errors = &messages;
+  while ((i = __atomic_fetch_add(&next_class_parse, 1, __ATOMIC_RELAXED))
+	 < nclass_parses) {
+    ClassParse *c = &class_parse[i];
+    symbol_caches = &c->symbols;
+    omerrs = 0;
+    parse_tokens(c->start, c->ntokens);
+    c->errors = omerrs;
+    c->ast_root = ast_root;
+    c->parse_results = parse_results;
+  }
+  return NULL;
+}
+
+static void parse_classes()
+{
+  int next_id = idtable.size();
+  int next_string = stringtable.size();
+  int next_int = inttable.size();
+  int ntokens, n, i;
+
+  scan_to_buffer(&class_tokens, NULL);
+  ntokens = class_tokens.ntokens;
+  for (n = 1, i = 1; i < ntokens; i++)
+    if (class_tokens.token[i].token == CLASS)
+      n++;
+  class_parse = new ClassParse[n];
+  class_parse[0].start = 0;
+  for (n = 1, i = 1; i < ntokens; i++)
+    if (class_tokens.token[i].token == CLASS)
+      class_parse[n++].start = i;
+  for (i = 0; i < n; i++)
+    class_parse[i].ntokens = (i + 1 < n ? class_parse[i + 1].start : ntokens) -
+			     class_parse[i].start;
+  nclass_parses = n;
+  next_class_parse = 0;
+  class_tokens_file = curr_filename;
+
+  // The parsers are not freed: the trees are built in their arenas.
+  int nthreads = class_threads < n ? class_threads : n;
+  ClassParser *parser = new ClassParser[nthreads];
+  for (i = 0; i < nthreads; i++)
+    if (pthread_create(&parser[i].thread, NULL, parse_classes_thread,
+		       &parser[i]) != 0) {
+      cerr << "Cannot start a parser thread\n";
+      exit(1);
+    }
+  for (i = 0; i < nthreads; i++)
+    pthread_join(parser[i].thread, NULL);
+
+  for (i = 0; i < n; i++) {
+    ClassParse *c = &class_parse[i];
+    next_id = idtable.renumber(next_id, c->symbols.ids);
+    next_string = stringtable.renumber(next_string, c->symbols.strings);
+    next_int = inttable.renumber(next_int, c->symbols.ints);
+    if (c->errors != 0) {
+      parse_tokens(c->start, ntokens - c->start);
+      break;
+    }
+    if (i == 0) {
+      ast_root = c->ast_root;
+      parse_results = c->parse_results;
+    } else
+      parse_results = append_Classes(parse_results, c->parse_results);
+  }
+
+  for (i = 0; i < n; i++) {
+    class_parse[i].symbols.ids.clear();
+    class_parse[i].symbols.strings.clear();
+    class_parse[i].symbols.ints.clear();
+  }
+  delete [] class_parse;
+  delete [] class_tokens.token;
+}
+
+int main(int argc, char *argv[]) {
+  handle_flags(argc,argv);
+  if (optind == argc) {
+      cerr << "usage: " << argv[0] << " [options] file.cl ...\n";
+      exit(1);
+  }
+
+  if (!out_filename) {   // no -o option: name the output after the first file
+      char *dot = strrchr(argv[optind], '.');
+      int len = dot ? dot - argv[optind] : strlen(argv[optind]);
+      out_filename = new char[len + 3];
+      strncpy(out_filename, argv[optind], len);
+      strcpy(out_filename + len, ".s");
+  }
+
+  //
+  // Lex and parse.
+  //
+  Classes classes = NULL;
+  int program_line = 1;
+  if (class_threads > 1)
+      pipeline_parse = 0;     // -J takes the place of -P
+  if (parallel_parse) {
+      pipeline_parse = 0;     // -j takes the place of -P
+      parse_files_in_parallel(argc - optind, argv + optind,
+			      &classes, &program_line);
+      optind = argc;
+  }
+  for (; optind < argc; optind++) {
+      if (!open_file(argv[optind])) {
+	  cerr << "Could not open input file " << argv[optind] << endl;
+	  exit(1);
+      }
+      curr_filename = argv[optind];
+      curr_lineno = 1;
+      int errors = omerrs;
+      ast_root = NULL;
+      parse_file();
+      if (omerrs == errors && ast_root != NULL) {
+	  if (classes == NULL) {
+	      program_line = ast_root->get_line_number();
+	      classes = parse_results;
+	  } else
+	      classes = append_Classes(classes, parse_results);
+      }
+  }
+  if (omerrs != 0) {
+      cerr << "Compilation halted due to lex and parse errors\n";
+      exit(1);
+  }
+  node_lineno = program_line;
+  program_class *program = new program_class(classes);
+
+  //
+  // Check the program, and don't touch the output file unless it passes.
+  //
+  program->semant();
+
+  ofstream s(out_filename);
+  if (!s) {
+      cerr << "Cannot open output file " << out_filename << endl;
+      exit(1);
+  }
+  program->cgen(s);
+  release_tree_nodes();
+  return 0;
+}
@@ -0,0 +1,104 @@
+// -*-Mode: C++;-*-
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <stdlib.h>
+#include <string.h>
+#include "cool-io.h"
+
+/////////////////////////////////////////////////////////////////////////
+//
+//  Arenas
+//
+//  An Arena is a bump-pointer allocator.  Storage is carved out of large
+//  chunks, so that objects allocated one after another sit contiguously
+//  in memory.  Individual allocations are never freed; the whole arena
+//  is released at once by clear().  The string tables keep their entries
+//  in arenas (see stringtab.h), and the tree nodes are kept in one too
+//  (see tree.h).
+//
+/////////////////////////////////////////////////////////////////////////
+
+//
+// Arena chunks are ARENA_CHUNK_SIZE bytes unless a single allocation
+// needs more.
+//
+#define ARENA_CHUNK_SIZE 65536
+
+class Arena {
+private:
+  struct Chunk {
+    Chunk *next;   // the previously allocated chunk
+    long  pad;     // keeps the chunk data suitably aligned
+  };
+  Chunk *chunks;   // the chunks of the arena, most recent first
+  char *free_ptr;  // next free byte of the current chunk
+  char *free_end;  // end of the current chunk
+
+  void new_chunk(int min_size);
+  static char *align_up(char *p, int align)
+  { return (char *) (((unsigned long) p + align - 1) & ~(unsigned long) (align - 1)); }
+public:
+  Arena(): chunks((Chunk *) NULL), free_ptr(NULL), free_end(NULL) { }
+
+  // allocate size bytes aligned on align (a power of two)
+  void *allocate(int size, int align);
+
+  // a null terminated copy of the first len characters of s
+  char *copy_string(char *s, int len);
+
+  // release all storage allocated from the arena
+  void clear();
+};
+
+inline void Arena::new_chunk(int min_size)
+{
+  int size = min_size > ARENA_CHUNK_SIZE ? min_size : ARENA_CHUNK_SIZE;
+  Chunk *c = (Chunk *) malloc(sizeof(Chunk) + size);
+  if (c == NULL) {
+    cerr << "out of memory in arena\n";
+    exit(1);
+  }
+  c->next = chunks;
+  chunks = c;
+  free_ptr = (char *) (c + 1);
+  free_end = free_ptr + size;
+}
+
+inline void *Arena::allocate(int size, int align)
+{
+  char *p = align_up(free_ptr, align);
+  if (free_ptr == NULL || p + size > free_end) {
+    new_chunk(size + align);
+    p = align_up(free_ptr, align);
+  }
+  free_ptr = p + size;
+  return p;
+}
+
+inline char *Arena::copy_string(char *s, int len)
+{
+  char *p = (char *) allocate(len + 1, 1);
+  memcpy(p, s, len);
+  p[len] = '\0';
+  return p;
+}
+
+inline void Arena::clear()
+{
+  while (chunks) {
+    Chunk *next = chunks->next;
+    free(chunks);
+    chunks = next;
+  }
+  free_ptr = free_end = NULL;
+}
+
+#endif
@@ -13,10 +13,25 @@
 #include <string.h>
 #include "list.h"    // list template
 #include "cool-io.h"
+#include "arena.h"
 
 class Entry;
 typedef Entry* Symbol;
 
+//
+// string_hash computes the hash used to index the string tables
+// (32-bit FNV-1a over the first len characters of s).
+//
+inline unsigned string_hash(const char *s, int len)
+{
+  unsigned h = 2166136261u;
+  for (int i = 0; i < len; i++) {
+    h ^= (unsigned char) s[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
 extern ostream& operator<<(ostream& s, const Entry& sym);
 extern ostream& operator<<(ostream& s, Symbol sym);
 
@@ -31,14 +46,23 @@ protected:
   char *str;     // the string
   int  len;      // the length of the string (without trailing \0)
   int index;     // a unique index for each string
+  unsigned hash; // string_hash(str,len), cached for the table's hash index
 public:
   Entry(char *s, int l, int i);
+  Entry(char *s, int l, int i, Arena& pool);  // str is stored in pool
 
   // is string argument equal to the str of this Entry?
   int equal_string(char *s, int len) const;  
+
+  // the cached hash of the string
+  unsigned get_hash() const                 { return hash; }
                          
   // is the integer argument equal to the index of this Entry?
   bool equal_index(int ind) const           { return ind == index; }
+  // the index of this Entry in its string table
+  int get_index() const                     { return index; }
+  // move this Entry to another index (see StringTable::renumber)
+  void set_index(int ind)                   { index = ind; }
 
   ostream& print(ostream& s) const;
 
@@ -65,11 +89,13 @@ public:
   void code_def(ostream& str, int stringclasstag);
   void code_ref(ostream& str);
   StringEntry(char *s, int l, int i);
+  StringEntry(char *s, int l, int i, Arena& pool);
 };
 
 class IdEntry : public Entry {
 public:
   IdEntry(char *s, int l, int i);
+  IdEntry(char *s, int l, int i, Arena& pool);
 };
 
 class IntEntry: public Entry {
@@ -77,6 +103,7 @@ public:
   void code_def(ostream& str, int intclasstag);
   void code_ref(ostream& str);
   IntEntry(char *s, int l, int i);
+  IntEntry(char *s, int l, int i, Arena& pool);
 };
 
 typedef StringEntry *StringEntryP;
@@ -93,10 +120,35 @@ template <class Elem>
 class StringTable
 {
 protected:
-   List<Elem> *tbl;   // a string table is a list
    int index;         // the current index
+
+   // The Entry objects of the table and their strings are allocated
+   // from `pool', so the whole table can be freed in one operation.
+   Arena pool;
+
+   // An open-addressing (linear probing) hash index over the entries,
+   // so that add_string and lookup_string don't scan the table.
+   // `buckets' has `capacity' slots, a power of two; empty slots are NULL.
+   Elem **buckets;
+   int capacity;
+
+   // A dense array mapping each index to its Entry, so that lookup and
+   // iteration by index are direct accesses.  `entries[i]' is valid for
+   // 0 <= i < index; the array has room for `entries_size' entries.
+   Elem **entries;
+   int entries_size;
+
+   // Set while a thread enters a string through add_chars_locked.
+   bool locked;
+
+   int find_slot(char *s, int len, unsigned h);  // slot of s, or empty slot
+   void grow();                                   // double the hash index
+   void append(Elem *e, int slot);                // e is the next index
 public:
-   StringTable(): tbl((List<Elem> *) NULL), index(0) { }   // an empty table
+   StringTable(): index(0),
+                  buckets((Elem **) NULL), capacity(0),
+                  entries((Elem **) NULL), entries_size(0),
+                  locked(false) { }   // an empty table
    // The following methods each add a string to the string table.  
    // Only one copy of each string is maintained.  
    // Returns a pointer to the string table entry with the string.
@@ -107,20 +159,36 @@ public:
    // add the (null terminated) string s
    Elem *add_string(char *s);
 
+   // add the len characters at s (which need not be null terminated)
+   Elem *add_chars(char *s, int len);
+
    // add the string representation of an integer
    Elem *add_int(int i);
 
+   // add_chars, for one of several threads that add strings at once
+   Elem *add_chars_locked(char *s, int len);
+
+   // Renumber the entries of `order' (a StringTableCache of this table)
+   // that are at index `next' or above, in the order of `order', from
+   // `next' on.  Returns the index after the last one renumbered.
+   int renumber(int next, StringTable<Elem> &order);
+
 
    // An iterator.
    int first();       // first index
    int more(int i);   // are there more indices?
    int next(int i);   // next index
+   int size()         { return index; }   // number of entries
 
    Elem *lookup(int index);      // lookup an element using its index
    Elem *lookup_string(char *s); // lookup an element using its string
 
    void print();  // print the entire table; for debugging
 
+   // Free every Entry of the table at once and make the table empty.
+   // All Symbols previously returned by the table become invalid.
+   void clear();
+
 };
 
 class IdTable : public StringTable<IdEntry> { };
@@ -140,4 +208,38 @@ public:
 extern IdTable idtable;
 extern IntTable inttable;
 extern StrTable stringtable;
+
+//
+// A StringTableCache stands in front of a table for one thread, when
+// several threads add strings to the table at once (coolc -j parses its
+// files on threads of their own).  The cache holds the Entries of the
+// table that its thread has added so far; a string found there does not
+// touch the table, and only the first time that a thread adds a string
+// does it take the table's lock.
+//
+// The indices that the table gives the strings then depend on which
+// thread got to them first.  The cache holds its Entries in the order
+// in which its thread first added them, so that afterwards the table
+// can be renumbered, cache by cache, in the order that a single thread
+// going through the files one after another would have given.
+//
+template <class Elem>
+class StringTableCache : public StringTable<Elem>
+{
+private:
+   StringTable<Elem> &table;
+public:
+   StringTableCache(StringTable<Elem> &t) : table(t) { }
+   Elem *add_chars(char *s, int len);
+};
+
+//
+// The caches of one thread, for the three tables.
+//
+struct SymbolCaches {
+   StringTableCache<IdEntry> ids;
+   StringTableCache<StringEntry> strings;
+   StringTableCache<IntEntry> ints;
+   SymbolCaches() : ids(idtable), strings(stringtable), ints(inttable) { }
+};
 #endif
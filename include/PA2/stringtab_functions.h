@@ -10,10 +10,15 @@
 
 #include "stringtab.h"
 #include <stdio.h>
+#include <new>       // placement new
+#include <sched.h>
 
 //
-// A string table is implemented a linked list of Entrys.  Each Entry
-// in the list has a unique string.
+// A string table is implemented as an array of Entrys indexed by their
+// unique index.  Each Entry in the table has a unique string.  The entries
+// are also indexed by an open-addressing hash table keyed on the string,
+// so that finding the Entry for a string takes constant time on average.
+// The Entry objects and their strings are allocated from the table's pool.
 //
 
 template <class Elem>
@@ -23,52 +28,190 @@ Elem *StringTable<Elem>::add_string(char *s)
 }
 
 //
-// Add a string requires two steps.  First, the list is searched; if the
-// string is found, a pointer to the existing Entry for that string is 
-// returned.  If the string is not found, a new Entry is created and added
-// to the list.
+// find_slot returns the slot of the hash index that holds the Entry for
+// the first len characters of s, or the empty slot where such an Entry
+// would be inserted.  Linear probing is used; the table is never more
+// than half full, so the probe sequence always reaches an empty slot.
+//
+template <class Elem>
+int StringTable<Elem>::find_slot(char *s, int len, unsigned h)
+{
+  int mask = capacity - 1;
+  int slot = h & mask;
+  Elem *e;
+
+  while ((e = buckets[slot]) != NULL) {
+    if (e->get_hash() == h && e->equal_string(s,len))
+      return slot;
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+//
+// grow doubles the size of the hash index and reinserts every Entry
+// using its cached hash.
+//
+template <class Elem>
+void StringTable<Elem>::grow()
+{
+  int old_capacity = capacity;
+  Elem **old_buckets = buckets;
+
+  capacity = old_capacity ? 2 * old_capacity : 64;
+  buckets = new Elem *[capacity];
+  for (int i = 0; i < capacity; i++)
+    buckets[i] = NULL;
+
+  int mask = capacity - 1;
+  for (int i = 0; i < old_capacity; i++) {
+    Elem *e = old_buckets[i];
+    if (e == NULL)
+      continue;
+    int slot = e->get_hash() & mask;
+    while (buckets[slot] != NULL)
+      slot = (slot + 1) & mask;
+    buckets[slot] = e;
+  }
+  delete [] old_buckets;
+}
+
+//
+// Add a string requires two steps.  First, the hash index is searched; if
+// the string is found, a pointer to the existing Entry for that string is
+// returned.  If the string is not found, a new Entry is created in the
+// table's pool and added to the index.
 //
 template <class Elem>
 Elem *StringTable<Elem>::add_string(char *s, int maxchars)
 {
-  int len = min((int) strlen(s),maxchars);
-  for(List<Elem> *l = tbl; l; l = l->tl())
-    if (l->hd()->equal_string(s,len))
-      return l->hd();
+  return add_chars(s, min((int) strlen(s),maxchars));
+}
 
-  Elem *e = new Elem(s,len,index++);
-  tbl = new List<Elem>(e, tbl);
+//
+// add_chars does the work of add_string for a string whose length is
+// already known, such as a token that lies inside a larger buffer;
+// s need not be null terminated.
+//
+template <class Elem>
+Elem *StringTable<Elem>::add_chars(char *s, int len)
+{
+  unsigned h = string_hash(s,len);
+
+  if (2 * (index + 1) > capacity)
+    grow();
+
+  int slot = find_slot(s,len,h);
+  if (buckets[slot])
+    return buckets[slot];
+
+  Elem *e = new (pool.allocate(sizeof(Elem), alignof(Elem)))
+                Elem(s,len,index,pool);
+  append(e, slot);
   return e;
 }
 
 //
-// To look up a string, the list is scanned until a matching Entry is located.
-// If no such entry is found, an assertion failure occurs.  Thus, this function
-// is used only for strings that one expects to find in the table.
+// append enters e into the empty slot of the hash index, and at the
+// next index.
+//
+template <class Elem>
+void StringTable<Elem>::append(Elem *e, int slot)
+{
+  if (index == entries_size) {
+    Elem **old_entries = entries;
+    entries_size = entries_size ? 2 * entries_size : 64;
+    entries = new Elem *[entries_size];
+    for (int i = 0; i < index; i++)
+      entries[i] = old_entries[i];
+    delete [] old_entries;
+  }
+  entries[index++] = e;
+  buckets[slot] = e;
+}
+
+//
+// add_chars_locked lets one thread at a time into add_chars.  Threads
+// seldom meet here (see StringTableCache), so one that finds the table
+// locked just gives up the processor until it is free.
+//
+template <class Elem>
+Elem *StringTable<Elem>::add_chars_locked(char *s, int len)
+{
+  while (__atomic_test_and_set(&locked, __ATOMIC_ACQUIRE))
+    sched_yield();
+  Elem *e = add_chars(s,len);
+  __atomic_clear(&locked, __ATOMIC_RELEASE);
+  return e;
+}
+
+//
+// renumber moves each Entry of `order' in turn to index `next', unless it
+// already lies below; the Entry that was at `next' takes its old index.
+//
+template <class Elem>
+int StringTable<Elem>::renumber(int next, StringTable<Elem> &order)
+{
+  for (int i = 0; i < order.size(); i++) {
+    Elem *e = order.lookup(i);
+    int at = e->get_index();
+    if (at < next)
+      continue;
+    Elem *d = entries[next];
+    entries[at] = d;
+    d->set_index(at);
+    entries[next] = e;
+    e->set_index(next);
+    next++;
+  }
+  return next;
+}
+
+//
+// A cache looks a string up in its own hash index first, and otherwise
+// adds it to the table, and the table's Entry to the cache.
+//
+template <class Elem>
+Elem *StringTableCache<Elem>::add_chars(char *s, int len)
+{
+  unsigned h = string_hash(s,len);
+
+  if (2 * (this->index + 1) > this->capacity)
+    this->grow();
+
+  int slot = this->find_slot(s,len,h);
+  if (this->buckets[slot])
+    return this->buckets[slot];
+
+  Elem *e = table.add_chars_locked(s,len);
+  this->append(e, slot);
+  return e;
+}
+
+//
+// To look up a string, the hash index is probed until a matching Entry is
+// located.  If no such entry is found, an assertion failure occurs.  Thus,
+// this function is used only for strings that one expects to find in the
+// table.
 //
 template <class Elem>
 Elem *StringTable<Elem>::lookup_string(char *s)
 {
   int len = strlen(s);
-  for(List<Elem> *l = tbl; l; l = l->tl())
-    if (l->hd()->equal_string(s,len))
-      return l->hd();
-  assert(0);   // fail if string is not found
-  return NULL; // to avoid compiler warning
+  Elem *e = capacity ? buckets[find_slot(s,len,string_hash(s,len))] : NULL;
+  assert(e);   // fail if string is not found
+  return e;
 }
 
 //
 // lookup is similar to lookup_string, but uses the index of the string
-// as the key.
+// as the key.  Indices are dense, so this is a direct array access.
 //
 template <class Elem>
 Elem *StringTable<Elem>::lookup(int ind)
 {
-  for(List<Elem> *l = tbl; l; l = l->tl())
-    if (l->hd()->equal_index(ind))
-      return l->hd();
-  assert(0);   // fail if string is not found
-  return NULL; // to avoid compiler warning
+  assert(ind >= 0 && ind < index);   // fail if string is not found
+  return entries[ind];
 }
 
 //
@@ -100,8 +243,29 @@ int StringTable<Elem>::next(int i)
   return i+1;
 }
 
+//
+// print lists the entries newest first.
+//
 template <class Elem>
 void StringTable<Elem>::print()
 {
-  list_print(cerr,tbl);
+  cerr << "[\n";
+  for (int i = index - 1; i >= 0; i--)
+    cerr << *entries[i] << " ";
+  cerr << "]\n";
+}
+
+//
+// clear releases the pool holding all the entries in one operation, and
+// the index arrays with it.  Entry objects have no destructors to run.
+//
+template <class Elem>
+void StringTable<Elem>::clear()
+{
+  pool.clear();
+  delete [] buckets;
+  delete [] entries;
+  buckets = NULL;
+  entries = NULL;
+  capacity = entries_size = index = 0;
 }
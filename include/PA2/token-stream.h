@@ -0,0 +1,45 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef TOKEN_STREAM_H
+#define TOKEN_STREAM_H
+///////////////////////////////////////////////////////////////////////////
+//
+// file: token-stream.h
+//
+// Binary token streams, passed from the lexer to the parser in place of
+// the text that dump_cool_token prints when the lexer is given the -B
+// flag (as binary AST files are passed between the later phases; see
+// compact-ast.h).  The layout is described in token-stream.cc.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "cool-io.h"
+#include "cool-parse.h"
+
+//
+// The writer: write_binary_name starts the tokens of the file `name'
+// (the "#name" line of a textual stream), and write_binary_token adds a
+// token, with its line and semantic value, as dump_cool_token prints
+// it.  The tokens are written in blocks; flush_binary_tokens writes
+// what is left, and must be called at the end.
+//
+void write_binary_name(ostream &s, char *name);
+void write_binary_token(ostream &s, int lineno, int token, YYSTYPE yylval);
+void flush_binary_tokens(ostream &s);
+
+//
+// The reader: read_binary_token returns the next token of the stream in
+// `in', or 0 at its end, as cool_yylex does; it sets cool_yylval,
+// curr_lineno and curr_filename.  is_binary_token_stream tells, before
+// anything has been read from `in', whether it holds a binary stream
+// rather than text.
+//
+int read_binary_token(FILE *in);
+bool is_binary_token_stream(FILE *in);
+
+#endif
@@ -16,6 +16,12 @@ typedef int Boolean;
 class Entry;
 typedef Entry *Symbol;
 
+/* the text of a token: len characters at text, in the lexer's input */
+struct Span {
+  char *text;
+  int len;
+};
+
 Boolean copy_Boolean(Boolean);
 void assert_Boolean(Boolean);
 void dump_Boolean(ostream &,int,Boolean);
@@ -149,7 +155,7 @@ typedef union YYSTYPE
 #line 46 "cool.y"
 {
   Boolean boolean;
-  Symbol symbol;
+  Span span;
   Program program;
   Class_ class_;
   Classes classes;
@@ -171,7 +177,7 @@ typedef union YYSTYPE
 # define YYSTYPE_IS_TRIVIAL 1
 #endif
 
-extern YYSTYPE cool_yylval;
+extern __thread YYSTYPE cool_yylval;   /* one per thread; see cool.y */
 
 #if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
 typedef struct YYLTYPE
@@ -15,9 +15,13 @@
 ///////////////////////////////////////////////////////////////////////////
  
 
+#include <stdint.h>
+#include "arena.h"
 #include "stringtab.h"
 #include "cool-io.h"
 
+class CompactAst;
+
 /////////////////////////////////////////////////////////////////////
 //
 //  tree_node
@@ -40,6 +44,27 @@
 //         is the output stream on which the node is to be printed; n is
 //         the number of spaces to indent the output.
 //
+//       tree_node *copy();
+//         returns a deep copy of the tree.
+//
+//       void dump_with_types(ostream& s,int n);
+//         prints the tree with the types of its expressions (see
+//         dumptype.cc).
+//
+//       int children();
+//       tree_node *child(int i);
+//         the number of subtrees of the node, and the ith of them: the
+//         subtrees of a constructor, in the order of its arguments, or
+//         the elements of a list.
+//
+//   dump, copy and dump_with_types walk the tree with a tree_walker
+//   (below), and so do not recurse.  What they do at each node is in
+//   the node's hooks for the walk: dump_pre, dump_in and dump_post
+//   print the parts of the node before, between and after its
+//   subtrees, and copy_node builds a copy of the node from copies of
+//   its subtrees.  Likewise encode_node adds the node to a CompactAst
+//   once its subtrees are encoded (see compact-ast.h).
+//
 //       int get_line_number();  return the line number
 //       Symbol get_type();      return the type 
 //
@@ -47,6 +72,15 @@
 //           sets the line number and type of "this" to the values in
 //           the argument tree_node.  Returns "this".
 //
+//   Tree nodes are allocated from `node_arena' by a class operator new,
+//   and so are the element arrays of AST lists.  delete does not free
+//   a node; release_tree_nodes() frees every node at once, after which
+//   no node of any tree may be used.
+//
+//   More exactly, nodes are allocated from `*node_pool', which is
+//   node_arena unless a thread that builds trees of its own (see coolc
+//   -j) points it at an arena of its own.  node_lineno, too, is one per
+//   thread.
 //
 ////////////////////////////////////////////////////////////////////////////
 class tree_node {
@@ -54,13 +88,92 @@ protected:
     int line_number;            // stash the line number when node is made
 public:
     tree_node();
-    virtual tree_node *copy() = 0;
     virtual ~tree_node() { }
-    virtual void dump(ostream& stream, int n) = 0;
+    tree_node *copy();
+    void dump(ostream& stream, int n);
+    void dump_with_types(ostream& stream, int n);
     int get_line_number();
     tree_node *set(tree_node *);
+
+    virtual int children()                    { return 0; }
+    virtual tree_node *child(int i)           { return NULL; }
+
+    // the hooks of dump, copy, encoding and dump_with_types; a pre hook
+    // returns the indentation of the node's subtrees
+    virtual int dump_pre(ostream& stream, int n) = 0;
+    virtual void dump_in(ostream& stream, int n, int i) { }
+    virtual void dump_post(ostream& stream, int n) { }
+    virtual tree_node *copy_node(tree_node **kids) = 0;
+    virtual uint32_t encode_node(CompactAst& a, uint32_t *kids) = 0;
+    virtual int dump_with_types_pre(ostream& stream, int n) { return n; }
+    virtual void dump_with_types_in(ostream& stream, int n, int i) { }
+    virtual void dump_with_types_post(ostream& stream, int n) { }
+
+    static void *operator new(size_t size);
+    static void operator delete(void *) { }
+};
+
+/////////////////////////////////////////////////////////////////////
+//
+//  tree_walker
+//
+//   A walk over a tree that does not recurse: the nodes on the path
+//   from the root to the current node are kept on a stack of the
+//   walker's own, on the heap, so that a deep tree (a long chain of
+//   lets, of nested ifs or of dispatches) takes memory in proportion
+//   to its depth, and no C stack.  walk(t, n) visits the nodes of t in
+//   depth-first order (the subtrees of a node as children and child
+//   give them), calling the hooks
+//
+//       int pre(tree_node *t, int n)
+//         on reaching t.  It returns the n that t's subtrees get, as n
+//         is the one that t got from its parent (walk's n, for the
+//         root): for a printer, the indentation.
+//
+//       void in(tree_node *t, int n, int i)
+//         between the subtrees i-1 and i of t.
+//
+//       void post(tree_node *t, int n)
+//         after the subtrees of t.
+//
+//   A pre hook may call skip_children(), and then the subtrees of t are
+//   not walked (post is still called).  The hooks do nothing by default;
+//   a walk overrides those it needs, and they usually call hooks of the
+//   node itself, which are virtual, to do what is particular to each
+//   kind of node.
+//
+/////////////////////////////////////////////////////////////////////
+class tree_walker {
+private:
+    struct frame {
+	tree_node *node;
+	int n;                  // the n of the node
+	int kid_n;              // the n of its subtrees
+	int next;               // the subtree to walk next
+	int nkids;              // or 0 if they are skipped
+    };
+    frame *stack;
+    int depth;
+    int size;
+    bool skip;
+
+    void enter(tree_node *t, int n);
+protected:
+    void skip_children()                      { skip = true; }
+public:
+    tree_walker() : stack(NULL), depth(0), size(0), skip(false) { }
+    virtual ~tree_walker()                    { delete [] stack; }
+    virtual int pre(tree_node *t, int n)      { return n; }
+    virtual void in(tree_node *t, int n, int i) { }
+    virtual void post(tree_node *t, int n)    { }
+    void walk(tree_node *t, int n);
 };
 
+extern Arena node_arena;
+extern __thread Arena *node_pool;
+extern __thread int node_lineno;
+void release_tree_nodes();
+
 ///////////////////////////////////////////////////////////////////
 //
 //  Lists of APS objects are implemented by the "list_node"
@@ -89,6 +202,18 @@ public:
 //     for(int i = l->first(); l->more(i); i = l->next(i))
 //         ... operate on l->nth(i) ...
 //
+//     iterator begin();
+//     iterator end();
+//       A forward iterator over the list elements, in order.  Each step
+//     takes constant time, and the iterator supports range-for:
+//
+//     for (Elem e : *l)
+//         ... operate on e ...
+//
+//     Elem *elems(int &len)
+//     returns the elements of the list as an array; "len" is set to the
+//     length of the list.  The array belongs to the list.
+//
 //      
 //     int len()
 //     returns the length of the list
@@ -110,11 +235,34 @@ public:
 //     list_node<Elem>::single(e);     where "e" has type Elem
 //     list_node<Elem>::append(l1,l2);
 //
+//     The result of append is flat: its elements are kept in an array,
+//     so len and nth take constant time however the list was built.
+//     Appending to the most recent extension of a list adds to the
+//     list's array in place (amortized constant time per element), so
+//     the left-nested appends built by the parser cost linear time
+//     overall.  Lists stay persistent: appending never changes the
+//     elements seen by an existing list.
+//
 //////////////////////////////////////////////////////////////////////////////
 
+template <class Elem> class append_node;
+
+//
+// list_iterator is the iterator type of list_node<Elem>.
+//
+template <class Elem> class list_iterator {
+    Elem *p;
+public:
+    list_iterator(Elem *q) : p(q) { }
+    Elem operator*() const                          { return *p; }
+    list_iterator<Elem> &operator++()               { p++; return *this; }
+    bool operator==(const list_iterator<Elem> &i) const { return p == i.p; }
+    bool operator!=(const list_iterator<Elem> &i) const { return p != i.p; }
+};
+
 template <class Elem> class list_node : public tree_node {
 public:
-    tree_node *copy()            { return copy_list(); }
+    list_node<Elem> *copy_list() { return (list_node<Elem> *) copy(); }
     Elem nth(int n);
     //
     // The next three define a simple iterator.
@@ -122,11 +270,23 @@ public:
     int first()      { return 0; }
     int next(int n)  { return n + 1; }
     int more(int n)  { return (n < len()); }
+    //
+    // A forward iterator over the elements.
+    //
+    typedef list_iterator<Elem> iterator;
+    iterator begin() { int n; return iterator(elems(n)); }
+    iterator end()   { int n; Elem *e = elems(n); return iterator(e + n); }
 
-    virtual list_node<Elem> *copy_list() = 0;
     virtual ~list_node() { }
     virtual int len() = 0;
     virtual Elem nth_length(int n, int &len) = 0;
+    virtual Elem *elems(int &len) = 0;
+    // this list as an append_node, or NULL if it is not one
+    virtual append_node<Elem> *flat() { return NULL; }
+
+    int children()               { return len(); }
+    tree_node *child(int i)      { int n; return elems(n)[i]; }
+    uint32_t encode_node(CompactAst& a, uint32_t *kids);
 
     static list_node<Elem> *nil();
     static list_node<Elem> *single(Elem);
@@ -139,10 +299,11 @@ extern int info_size;
 
 template <class Elem> class nil_node : public list_node<Elem> {
 public:
-    list_node<Elem> *copy_list();
+    tree_node *copy_node(tree_node **kids);
     int len();
     Elem nth_length(int n, int &len);
-    void dump(ostream& stream, int n);
+    Elem *elems(int &len)      { len = 0; return NULL; }
+    int dump_pre(ostream& stream, int n);
 };
 
 template <class Elem> class single_list_node : public list_node<Elem> {
@@ -151,26 +312,43 @@ public:
     single_list_node(Elem t) {
 	elem = t;
     }
-    list_node<Elem> *copy_list();
+    tree_node *copy_node(tree_node **kids);
     int len();
     Elem nth_length(int n, int &len);
-    void dump(ostream& stream, int n);
+    Elem *elems(int &len)      { len = 1; return &elem; }
+    int dump_pre(ostream& stream, int n);
 };
 
 
+//
+// The elements of an append_node.  A buffer may be shared by several
+// append_nodes; each sees a prefix of `elems', and `used' is the length
+// of the longest one.
+//
+template <class Elem> struct list_buffer {
+    Elem *elems;
+    int used;
+    int capacity;
+};
+
 template <class Elem> class append_node : public list_node<Elem> {
 private:
-    list_node<Elem> *some, *rest;
+    list_buffer<Elem> *buf;
+    int length;                 // this list is buf->elems[0..length-1]
+
+    append_node() : buf(NULL), length(0) { }
+    void push(Elem e);
+    void push_list(list_node<Elem> *l);
 public:
-    append_node(list_node<Elem> *l1, list_node<Elem> *l2) {
-	some = l1;
-	rest = l2;
-    }
-    list_node<Elem> *copy_list();
+    append_node(list_node<Elem> *l1, list_node<Elem> *l2);
+    append_node<Elem> *flat()    { return this; }
+    tree_node *copy_node(tree_node **kids);
     int len();
     Elem nth(int n);
     Elem nth_length(int n, int &len);
-    void dump(ostream& stream, int n);
+    Elem *elems(int &len)      { len = length; return buf ? buf->elems : NULL; }
+    int dump_pre(ostream& stream, int n);
+    void dump_post(ostream& stream, int n);
 };
 
 
@@ -223,12 +401,12 @@ template <class Elem> Elem append_node<Elem>::nth(int n)
 
 ///////////////////////////////////////////////////////////////////////////
 //
-// nil_node::copy_list
+// nil_node::copy_node
 //
-// return the deep copy of the nil_node
+// return a copy of the nil_node
 //
 ///////////////////////////////////////////////////////////////////////////
-template <class Elem> list_node<Elem> *nil_node<Elem>::copy_list()
+template <class Elem> tree_node *nil_node<Elem>::copy_node(tree_node **)
 {
     return new nil_node<Elem>();
 }
@@ -264,27 +442,28 @@ template <class Elem> Elem nil_node<Elem>::nth_length(int, int &len)
 
 ///////////////////////////////////////////////////////////////////////////
 //
-// nil_node::dump
+// nil_node::dump_pre
 //
 // dump for list node
 //
 ///////////////////////////////////////////////////////////////////////////
-template <class Elem> void nil_node<Elem>::dump(ostream& stream, int n)
+template <class Elem> int nil_node<Elem>::dump_pre(ostream& stream, int n)
 {
     stream << pad(n) << "(nil)\n";
+    return n;
 }
 
 
 ///////////////////////////////////////////////////////////////////////////
 //
-// single_list_node::copy_list
+// single_list_node::copy_node
 //
-// return the deep copy of the single_list_node
+// return a copy of the single_list_node, given the copy of its element
 //
 ///////////////////////////////////////////////////////////////////////////
-template <class Elem> list_node<Elem> *single_list_node<Elem>::copy_list()
+template <class Elem> tree_node *single_list_node<Elem>::copy_node(tree_node **kids)
 {
-    return new single_list_node<Elem>((Elem) elem->copy());
+    return new single_list_node<Elem>((Elem) kids[0]);
 }
 
 
@@ -320,27 +499,105 @@ template <class Elem> Elem single_list_node<Elem>::nth_length(int n, int &len)
 
 ///////////////////////////////////////////////////////////////////////////
 //
-// single_list_node::dump
+// single_list_node::dump_pre
 //
-// dump for list node
+// dump for list node: the element is dumped at the list's indentation
+//
+///////////////////////////////////////////////////////////////////////////
+template <class Elem> int single_list_node<Elem>::dump_pre(ostream& stream, int n)
+{
+    return n;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// append_node::append_node
+//
+// build the concatenation of l1 and l2.  If l1 is the longest list on
+// its buffer, the buffer is extended in place; otherwise the elements
+// of l1 are copied to a new buffer.
+//
+///////////////////////////////////////////////////////////////////////////
+template <class Elem> append_node<Elem>::append_node(list_node<Elem> *l1,
+						     list_node<Elem> *l2)
+{
+    append_node<Elem> *a = l1->flat();
+
+    if (a && a->buf && a->length == a->buf->used) {
+	buf = a->buf;
+	length = a->length;
+    } else {
+	buf = NULL;
+	length = 0;
+	push_list(l1);
+    }
+    push_list(l2);
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// append_node::push
+//
+// add e to the end of the list, which must be the longest list on its
+// buffer
 //
 ///////////////////////////////////////////////////////////////////////////
-template <class Elem> void single_list_node<Elem>::dump(ostream& stream, int n)
+template <class Elem> void append_node<Elem>::push(Elem e)
 {
-    elem->dump(stream, n);
+    if (!buf) {
+	buf = (list_buffer<Elem> *)
+	    node_pool->allocate(sizeof(list_buffer<Elem>), alignof(list_buffer<Elem>));
+	buf->elems = NULL;
+	buf->used = 0;
+	buf->capacity = 0;
+    }
+    if (length == buf->capacity) {
+	// Lists sharing the old buffer keep it; they only read their prefix.
+	list_buffer<Elem> *nbuf = (list_buffer<Elem> *)
+	    node_pool->allocate(sizeof(list_buffer<Elem>), alignof(list_buffer<Elem>));
+	nbuf->capacity = buf->capacity ? 2 * buf->capacity : 4;
+	nbuf->elems = (Elem *)
+	    node_pool->allocate(nbuf->capacity * sizeof(Elem), alignof(Elem));
+	for (int i = 0; i < length; i++)
+	    nbuf->elems[i] = buf->elems[i];
+	nbuf->used = length;
+	buf = nbuf;
+    }
+    buf->elems[length++] = e;
+    buf->used = length;
 }
 
 
 ///////////////////////////////////////////////////////////////////////////
 //
-// append_node::copy_list
+// append_node::push_list
 //
-// return the deep copy of the append_node
+// add the elements of l to the end of the list
 //
 ///////////////////////////////////////////////////////////////////////////
-template <class Elem> list_node<Elem> *append_node<Elem>::copy_list()
+template <class Elem> void append_node<Elem>::push_list(list_node<Elem> *l)
 {
-    return new append_node<Elem>(some->copy_list(), rest->copy_list());
+    for (Elem e : *l)
+	push(e);
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// append_node::copy_node
+//
+// return a copy of the append_node, given the copies of its elements
+//
+///////////////////////////////////////////////////////////////////////////
+template <class Elem> tree_node *append_node<Elem>::copy_node(tree_node **kids)
+{
+    append_node<Elem> *l = new append_node<Elem>();
+
+    for (int i = 0; i < length; i++)
+	l->push((Elem) kids[i]);
+    return l;
 }
 
 
@@ -353,7 +610,7 @@ template <class Elem> list_node<Elem> *append_node<Elem>::copy_list()
 ///////////////////////////////////////////////////////////////////////////
 template <class Elem> int append_node<Elem>::len()
 {
-    return some->len() + rest->len();
+    return length;
 }
 
 
@@ -366,32 +623,28 @@ template <class Elem> int append_node<Elem>::len()
 ///////////////////////////////////////////////////////////////////////////
 template <class Elem> Elem append_node<Elem>::nth_length(int n, int &len)
 {
-    int rlen;
-    Elem tmp = some->nth_length(n, len);
-
-    if (!tmp) {
-	tmp = rest->nth_length(n-len, rlen);
-	len += rlen;
-    }
-    return tmp;
+    len = length;
+    if (n < 0 || n >= length)
+	return NULL;
+    return buf->elems[n];
 }
 
 
 ///////////////////////////////////////////////////////////////////////////
 //
-// append_node::dump
+// append_node::dump_pre, append_node::dump_post
 //
 // dump for list node
 //
 ///////////////////////////////////////////////////////////////////////////
-template <class Elem> void append_node<Elem>::dump(ostream& stream, int n)
+template <class Elem> int append_node<Elem>::dump_pre(ostream& stream, int n)
 {
-    int i, size;
-
-    size = len();
     stream << pad(n) << "list\n";
-    for (i = 0; i < size; i++)
-      nth(i)->dump(stream, n+2);
+    return n+2;
+}
+
+template <class Elem> void append_node<Elem>::dump_post(ostream& stream, int n)
+{
     stream << pad(n) << "(end_of_list)\n";
 }
 
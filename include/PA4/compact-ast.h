@@ -0,0 +1,128 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef COMPACT_AST_H
+#define COMPACT_AST_H
+///////////////////////////////////////////////////////////////////////////
+//
+// file: compact-ast.h
+//
+// A compact, index-based encoding of a COOL abstract syntax tree.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include "cool-tree.h"
+
+//
+// The kind of a compact AST node: one per constructor of cool-tree.h,
+// plus AST_LIST for the lists of any phylum.
+//
+enum AstKind {
+   AST_PROGRAM, AST_CLASS, AST_METHOD, AST_ATTR, AST_FORMAL, AST_BRANCH,
+   AST_ASSIGN, AST_STATIC_DISPATCH, AST_DISPATCH, AST_COND, AST_LOOP,
+   AST_TYPCASE, AST_BLOCK, AST_LET, AST_PLUS, AST_SUB, AST_MUL,
+   AST_DIVIDE, AST_NEG, AST_LT, AST_EQ, AST_LEQ, AST_COMP, AST_INT_CONST,
+   AST_BOOL_CONST, AST_STRING_CONST, AST_NEW, AST_ISVOID, AST_NO_EXPR,
+   AST_OBJECT, AST_LIST
+};
+
+/////////////////////////////////////////////////////////////////////////
+//
+//  CompactAst
+//
+//  The nodes of a tree are stored as parallel arrays indexed by a 32-bit
+//  node number:
+//
+//     kind[i]       the AstKind of node i, as a uint8_t
+//     first_op[i]   node i's operands are ops[first_op[i]] up to (but not
+//                   including) ops[first_op[i+1]]
+//     line[i]       the line number of node i (a side table; nothing
+//                   else refers to it)
+//
+//  Operands are 32-bit values whose meaning is fixed by the node kind;
+//  they follow the constructor arguments of cool-tree.h, in order, and
+//  an expression node has its type as an extra last operand.  An operand
+//  is one of:
+//
+//     a node number          children, including lists
+//     a symbol reference     see symbol_ref
+//     a plain integer        the value of a bool_const
+//
+//  The operands of an AST_LIST node are its elements.  Nodes are stored
+//  children first, so every operand node number is smaller than the
+//  node's own number and the root is the last node.
+//
+//  Symbols are referenced by their string table and their index in it,
+//  so an encoding is only meaningful together with the current idtable,
+//  stringtable and inttable.
+//
+//  program_class::encode builds the encoding of a tree (through the
+//  encode_node hooks of its nodes, with a tree_walker), and decode
+//  builds a tree of cool-tree.h nodes from an encoding.
+//
+//  write saves an encoding, with the symbols it refers to, as a binary AST
+//  file (the layout is described in compact-ast.cc).  load reads one
+//  back from memory without copying the node arrays: they point into
+//  the file's buffer, which must outlive the CompactAst.
+//
+/////////////////////////////////////////////////////////////////////////
+
+class CompactAst {
+private:
+   bool owned;          // the arrays were allocated by this CompactAst
+   int nodes_size;      // room in kind, first_op and line
+   int ops_size;        // room in ops
+
+public:
+   uint8_t *kind;
+   uint32_t *first_op;  // has nnodes + 1 entries
+   uint32_t *ops;
+   int *line;
+   int nnodes;
+   int nops;
+
+   CompactAst();
+   ~CompactAst();
+   void clear();
+
+   int size()                   { return nnodes; }
+   uint32_t root()              { return nnodes - 1; }
+   int arity(uint32_t n)        { return first_op[n + 1] - first_op[n]; }
+   uint32_t op(uint32_t n, int i) { return ops[first_op[n] + i]; }
+
+   //
+   // Building an encoding.  Once its children are encoded, a node is
+   // added with begin_node and its operands with add_op.
+   //
+   uint32_t begin_node(AstKind k, int line_number);
+   void add_op(uint32_t x);
+
+   //
+   // A symbol reference holds the table of the symbol in its top two
+   // bits and the symbol's index in that table in the rest.  NO_SYMBOL
+   // encodes NULL.
+   //
+   enum { SYM_ID = 0, SYM_STRING = 1, SYM_INT = 2 };
+   static const uint32_t NO_SYMBOL = 0xffffffff;
+   static uint32_t symbol_ref(Symbol s);
+   static Symbol symbol(uint32_t r);
+
+   // The tree encoded by this CompactAst.
+   Program decode();
+
+   // Binary AST files.
+   void write(ostream &s);
+   void load(char *buf, long size);
+};
+
+//
+// read_binary_ast reads a binary AST file from the file descriptor fd
+// (mapping it into memory when possible) and returns the tree.
+//
+Program read_binary_ast(int fd);
+
+#endif
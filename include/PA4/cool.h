@@ -14,6 +14,12 @@ typedef int Boolean;
 class Entry;
 typedef Entry *Symbol;
 
+/* the text of a token: len characters at text, in the lexer's input */
+struct Span {
+  char *text;
+  int len;
+};
+
 Boolean copy_Boolean(Boolean);
 void assert_Boolean(Boolean);
 void dump_Boolean(ostream &,int,Boolean);
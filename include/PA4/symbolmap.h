@@ -0,0 +1,283 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+// Dense maps from Symbols to data.
+//
+// Every Entry of a string table carries a unique index, so data
+// attached to the symbols of one table can be kept in a flat array
+// indexed by Entry index.  A lookup is a single array access.
+//
+// Create a map with :
+// SymbolMap<info to store> name();            keys from idtable
+// SymbolMap<info to store> name(table);       keys from `table'
+//
+// All keys of a map must come from the same string table.
+
+#ifndef _SYMBOLMAP_H_
+#define _SYMBOLMAP_H_
+
+#include "stringtab.h"
+
+//
+// SymbolMap<T> maps Symbols to data of type `T'.  A symbol that has
+//    not been set maps to `T()' (NULL for pointer types).
+//
+//    `set(s,x)' maps `s' to `x', replacing any previous value.
+//
+//    `lookup(s)' returns the value of `s', or `T()' if `s' is unset.
+//
+//    `contains(s)' is true if `s' has been set.
+//
+//    `remove(s)' unsets `s'; `clear()' unsets every symbol.
+//
+//    The array grows on demand.  When it must grow it is resized to
+//    cover the whole of the key table (or double its size, if that
+//    is larger), so a map keyed by idtable is resized only a few times
+//    however the table is filled.
+//
+
+template <class T>
+class SymbolMap
+{
+protected:
+   struct Slot {
+      T value;
+      int scope;        // 0 if the symbol is unset; see ScopedSymbolMap
+   };
+
+   StringTable<IdEntry> *table;   // the table the keys come from
+   Slot *slots;                   // slots[i] holds the symbol of index i
+   int size;                      // number of slots
+   int nset;                      // number of set symbols
+
+   // The index of `s' in the key table.
+   int index_of(Symbol s)
+   {
+       int i = s->get_index();
+       assert(i < table->size() && (Symbol) table->lookup(i) == s);
+       return i;
+   }
+
+   // The slot of index `i', growing the array if needed.
+   Slot *slot(int i)
+   {
+       if (i >= size) {
+	   int new_size = size ? 2 * size : 64;
+	   if (new_size < table->size())
+	       new_size = table->size();
+	   while (new_size <= i)
+	       new_size *= 2;
+	   Slot *new_slots = new Slot[new_size];
+	   for (int j = 0; j < size; j++)
+	       new_slots[j] = slots[j];
+	   for (int j = size; j < new_size; j++) {
+	       new_slots[j].value = T();
+	       new_slots[j].scope = 0;
+	   }
+	   delete [] slots;
+	   slots = new_slots;
+	   size = new_size;
+       }
+       return &slots[i];
+   }
+
+private:
+   SymbolMap(const SymbolMap &);               // not copyable
+   SymbolMap &operator =(const SymbolMap &);
+
+public:
+   SymbolMap(StringTable<IdEntry> &t = idtable)
+      : table(&t), slots(NULL), size(0), nset(0) { }
+   ~SymbolMap() { delete [] slots; }
+
+   T lookup(Symbol s)
+   {
+       int i = index_of(s);
+       return i < size ? slots[i].value : T();
+   }
+
+   bool contains(Symbol s)
+   {
+       int i = index_of(s);
+       return i < size && slots[i].scope != 0;
+   }
+
+   void set(Symbol s, T x)
+   {
+       Slot *sl = slot(index_of(s));
+       if (sl->scope == 0) nset++;
+       sl->value = x;
+       sl->scope = 1;
+   }
+
+   void remove(Symbol s)
+   {
+       int i = index_of(s);
+       if (i < size && slots[i].scope != 0) {
+	   slots[i].value = T();
+	   slots[i].scope = 0;
+	   nset--;
+       }
+   }
+
+   bool empty() { return nset == 0; }
+
+   void clear()
+   {
+       for (int i = 0; i < size; i++) {
+	   slots[i].value = T();
+	   slots[i].scope = 0;
+       }
+       nset = 0;
+   }
+};
+
+//
+// ScopedSymbolMap<T> is a SymbolMap with nested scopes, with the same
+//    interface as SymbolTable<Symbol,T>.  Each binding records the
+//    binding it hides on an undo log, and `exitscope' replays the log
+//    back to the start of the scope.
+//
+//    `enterscope' pushes a new, empty scope.
+//
+//    `exitscope' pops the current scope, making the bindings hidden
+//        by that scope visible again.
+//
+//    `addid(s,x)' binds `s' to `x' in the current scope.
+//
+//    `lookup(s)' returns the value of the innermost binding of `s',
+//        or `T()' if `s' is unbound.
+//
+//    `probe(s)' returns the value of `s' if it is bound in the
+//        current scope, and `T()' otherwise.
+//
+//    `dump()' prints the symbols in the table.
+//
+//    lookup, probe and addid take constant time, and exitscope takes
+//    time proportional to the size of the scope.
+//
+
+template <class T>
+class ScopedSymbolMap : protected SymbolMap<T>
+{
+   typedef typename SymbolMap<T>::Slot Slot;
+
+   // An undo log record: the slot `index' held `value' bound at
+   // depth `scope' before the binding that pushed the record.
+   struct Undo {
+      int index;
+      T value;
+      int scope;
+   };
+
+private:
+   Undo *log;                 // the undo log
+   int log_size;
+   int nlog;                  // height of the undo log
+
+   int *scopes;               // scopes[d] is the log height when scope d
+   int scopes_size;           //    was entered
+   int depth;                 // number of open scopes
+
+   void push_undo(int i, Slot *sl)
+   {
+       if (nlog == log_size) {
+	   Undo *old_log = log;
+	   log_size = log_size ? 2 * log_size : 64;
+	   log = new Undo[log_size];
+	   for (int n = 0; n < nlog; n++)
+	       log[n] = old_log[n];
+	   delete [] old_log;
+       }
+       log[nlog].index = i;
+       log[nlog].value = sl->value;
+       log[nlog].scope = sl->scope;
+       nlog++;
+   }
+
+public:
+   ScopedSymbolMap(StringTable<IdEntry> &t = idtable)
+      : SymbolMap<T>(t), log(NULL), log_size(0), nlog(0),
+	scopes(NULL), scopes_size(0), depth(0) { }
+   ~ScopedSymbolMap() { delete [] log; delete [] scopes; }
+
+   void fatal_error(char * msg)
+   {
+     cerr << msg << "\n";
+     exit(1);
+   }
+
+   // Enter a new scope.  A scope must be entered before anything
+   // can be added to the table.
+   void enterscope()
+   {
+       if (depth == scopes_size) {
+	   int *old_scopes = scopes;
+	   scopes_size = scopes_size ? 2 * scopes_size : 16;
+	   scopes = new int[scopes_size];
+	   for (int d = 0; d < depth; d++)
+	       scopes[d] = old_scopes[d];
+	   delete [] old_scopes;
+       }
+       scopes[depth++] = nlog;
+   }
+
+   // Pop the current scope, undoing its bindings.
+   void exitscope()
+   {
+       if (depth == 0) {
+	   fatal_error("exitscope: Can't remove scope from an empty symbol table.");
+       }
+       int start = scopes[--depth];
+       while (nlog > start) {
+	   Undo &u = log[--nlog];
+	   Slot &sl = this->slots[u.index];
+	   sl.value = u.value;
+	   sl.scope = u.scope;
+       }
+   }
+
+   // Bind `s' to `x' in the current scope.
+   void addid(Symbol s, T x)
+   {
+       if (depth == 0) fatal_error("addid: Can't add a symbol without a scope.");
+       int i = this->index_of(s);
+       Slot *sl = this->slot(i);
+       push_undo(i, sl);
+       sl->value = x;
+       sl->scope = depth;
+   }
+
+   T lookup(Symbol s) { return SymbolMap<T>::lookup(s); }
+
+   // Look up `s' in the current scope only.
+   T probe(Symbol s)
+   {
+       if (depth == 0) {
+	   fatal_error("probe: No scope in symbol table.");
+       }
+       int i = this->index_of(s);
+       if (i < this->size && this->slots[i].scope == depth)
+	   return this->slots[i].value;
+       return T();
+   }
+
+   // Prints out the contents of the table, innermost scope and newest
+   // binding first.
+   void dump()
+   {
+      int end = nlog;
+      for (int d = depth - 1; d >= 0; d--) {
+         cerr << "\nScope: \n";
+         for (int n = end - 1; n >= scopes[d]; n--) {
+            cerr << "  " << this->table->lookup(log[n].index) << endl;
+         }
+         end = scopes[d];
+      }
+   }
+};
+
+#endif
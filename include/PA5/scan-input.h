@@ -0,0 +1,60 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _SCAN_INPUT_H_
+#define _SCAN_INPUT_H_
+
+#include <stdio.h>
+#include <stddef.h>
+
+//
+// The input of a scanner: the text of a whole file, in memory, followed
+// by two null bytes.  scan_input_open maps the file `name' into memory,
+// or reads it whole if it cannot be mapped (a pipe, say), and returns
+// false if it cannot be opened; the text is writable, and stays where
+// it is until scan_input_close.  See scan-input.cc.
+//
+// The scanners do not count lines.  scan_input_open also makes an index
+// of the newlines in the text, and scan_input_line(in, p) is the number
+// of the line that the text up to p ends on: one more than the number
+// of newlines before p.
+//
+struct ScanInput {
+  char *text;
+  size_t len;       // not counting the two null bytes
+  size_t mapped;    // the size of the mapping, or 0 if the text was read
+  size_t *newline;  // the offsets of the newlines in text, in order
+  int nnewlines;
+  int line_hint;    // the number of newlines before the last p asked about
+};
+
+extern bool scan_input_open(char *name, ScanInput *in);
+extern void scan_input_close(ScanInput *in);
+extern int scan_input_seek_line(ScanInput *in, size_t offset);
+
+inline int scan_input_line(ScanInput *in, char *p)
+{
+  size_t offset = p - in->text;
+  int i = in->line_hint;
+
+  if (i > 0 && in->newline[i - 1] >= offset)
+    return scan_input_seek_line(in, offset);
+  while (in->newline[i] < offset)      // the index ends with a sentinel
+    i++;
+  in->line_hint = i;
+  return i + 1;
+}
+
+//
+// skip_trivia(p, end, &layer, out) returns the first character at or
+// after p that does not belong to whitespace or a comment, as the rules
+// of cool.flex would scan them.  See scan-input.cc.
+//
+extern char *skip_trivia(char *p, char *end, int *layer, FILE *out);
+
+#define IS_BLANK(c)	((c) == ' ' || ((c) >= '\t' && (c) <= '\r'))
+
+#endif
@@ -14,11 +14,12 @@
 #ifndef _SYMTAB_H_
 #define _SYMTAB_H_
 
+#include <new>      // placement new
 #include "list.h"
 
 //
 // SymtabEnty<SYM,DAT> defines the entry for a symbol table that associates
-//    symbols of type `SYM' with data of type `DAT *'.  
+//    symbols of type `SYM' with data of type `DAT *'.
 //
 
 template <class SYM, class DAT>
@@ -33,138 +34,277 @@ public:
 };
 
 //
-// SymbolTable<SYM,DAT> describes a symbol table mapping symbols of
-//    type `SYM' to data of type `DAT *'.  It is implemented as a
-//    list of lists of `SymtabEntry<SYM,DAT> *'.  The inner list is
-//    a scope, a mapping from symbols to data, and the outer list is
-//    a list of scopes. 
+// symtab_hash<SYM> hashes a symbol table key.  Keys are compared by
+//    value with `==', so for pointer keys (Symbol, char *) the pointer
+//    itself is hashed.
 //
-//    `tbl' points to the current top scope.
+
+template <class SYM>
+inline unsigned long symtab_hash(SYM s)
+{
+  unsigned long h = (unsigned long) s;
+  h ^= h >> 17;
+  h *= 0xed5ad4bbUL;
+  h ^= h >> 11;
+  return h;
+}
+
 //
-//    `enterscope' makes the table point to a new scope whose parent
-//       is the scope it pointed to previously.
+// SymbolTable<SYM,DAT> describes a symbol table mapping symbols of
+//    type `SYM' to data of type `DAT *'.  It is implemented as a hash
+//    table from each symbol to its innermost binding, plus a stack of
+//    bindings that serves as an undo log: each binding remembers the
+//    binding of the same symbol that it shadows, and `scopes' records
+//    where each scope starts on the stack.
+//
+//    `enterscope' pushes a new, empty scope.
 //
-//    `exitscope' makes the table point to the parent scope of the
-//        current scope.  Note that the old child scope is not
-//        deallocated.  One may save the state of a symbol table
-//        at a given point by copying it with `operator ='
+//    `exitscope' pops the current scope.  The bindings made in that
+//        scope are undone newest first, making the bindings they
+//        shadowed visible again.  The storage of the popped bindings
+//        is reused, so an entry returned by `addid' is only valid
+//        until its scope is exited.  One may save the state of a
+//        symbol table at a given point by copying it with `operator ='.
 //
 //    `addid(s,i)' adds a symbol table entry to the current scope of
-//        the symbol table mapping symbol `s' to data `d'.  The old
-//        top scope isn't modified; a new scope is created whose
-//        entry list is the new entry followed by the old entry list,
-//        and whose tail is the old top scope's parent.  The table
-//        is made to point to this new scope.
-//
-//    `lookup(s)' looks for the symbol `s', starting at the top scope
-//        and proceeding down the list of scopes until either an
-//        entry is found whose `get_id()' equals `s', or the end of
-//        the root scope is reached.  It returns the data item
-//        associated with the entry, or NULL if no such entry exists.
-//
-//    
-//    `probe(s)' checks the top scope for an entry whose `get_id()'
-//        equals `s', and returns the entry's `get_info()' if
-//        found, and NULL otherwise.
+//        the symbol table mapping symbol `s' to data `d'.  The new
+//        binding hides any other binding of `s', including one in
+//        the same scope.
+//
+//    `lookup(s)' returns the data item of the innermost binding of
+//        `s' in any scope, or NULL if no such binding exists.
+//
+//    `probe(s)' returns the data item of the innermost binding of `s'
+//        if that binding is in the top scope, and NULL otherwise.
 //
 //    `dump()' prints the symbols in the symbol table.
 //
+//    lookup, probe and addid take constant time on average, and
+//    exitscope takes time proportional to the size of the scope.
+//
 
 template <class SYM, class DAT>
 class SymbolTable
 {
    typedef SymtabEntry<SYM,DAT> ScopeEntry;
-   typedef List<ScopeEntry> Scope;
-   typedef List<Scope> ScopeList;
+
+   // A binding of a symbol in a scope.
+   struct Binding {
+      ScopeEntry entry;
+      int scope;              // depth of the scope holding the binding
+      Binding *shadowed;      // the binding this one hides, or NULL
+
+      Binding(SYM s, DAT *i, int d, Binding *sh)
+	 : entry(s,i), scope(d), shadowed(sh) { }
+   };
+
+   // A slot of the hash table.  Once a symbol has a slot it keeps it;
+   // `current' is NULL while the symbol is unbound, and in empty slots.
+   struct Slot {
+      SYM id;
+      Binding *current;       // innermost binding of id, or NULL
+      bool used;
+   };
+
+   enum { BLOCK_SIZE = 256 };  // bindings per block of the binding stack
+
 private:
-   ScopeList  *tbl;
+   Slot *slots;               // the hash table; `nslots' is a power of two
+   int nslots;
+   int nkeys;                 // number of used slots
+
+   Binding **blocks;          // the binding stack, in blocks that never move
+   int nblocks;
+   int nbindings;             // height of the binding stack
+
+   int *scopes;               // scopes[d] is the stack height when scope d
+   int scopes_size;           //    was entered
+   int depth;                 // number of open scopes
+
+   Slot *find_slot(SYM s)
+   {
+       unsigned long mask = nslots - 1;
+       unsigned long i = symtab_hash(s) & mask;
+       while (slots[i].used && !(slots[i].id == s))
+	   i = (i + 1) & mask;
+       return &slots[i];
+   }
+
+   // The slot for `s', claiming a new one if `s' has none.
+   Slot *insert_slot(SYM s)
+   {
+       if (2 * (nkeys + 1) > nslots) {
+	   Slot *old_slots = slots;
+	   int old_nslots = nslots;
+	   nslots = nslots ? 2 * nslots : 64;
+	   slots = new Slot[nslots];
+	   for (int i = 0; i < nslots; i++) {
+	       slots[i].used = false;
+	       slots[i].current = NULL;
+	   }
+	   for (int i = 0; i < old_nslots; i++)
+	       if (old_slots[i].used)
+		   *find_slot(old_slots[i].id) = old_slots[i];
+	   delete [] old_slots;
+       }
+       Slot *slot = find_slot(s);
+       if (!slot->used) {
+	   slot->used = true;
+	   slot->id = s;
+	   slot->current = NULL;
+	   nkeys++;
+       }
+       return slot;
+   }
+
+   Binding *binding(int n) const { return &blocks[n / BLOCK_SIZE][n % BLOCK_SIZE]; }
+
+   // Storage for the next binding on the stack.
+   void *push_binding()
+   {
+       if (nbindings == nblocks * BLOCK_SIZE) {
+	   Binding **old_blocks = blocks;
+	   blocks = new Binding *[nblocks + 1];
+	   for (int i = 0; i < nblocks; i++)
+	       blocks[i] = old_blocks[i];
+	   delete [] old_blocks;
+	   blocks[nblocks++] =
+	       (Binding *) ::operator new(BLOCK_SIZE * sizeof(Binding));
+       }
+       return binding(nbindings++);
+   }
+
+   void clear()
+   {
+       delete [] slots;
+       for (int i = 0; i < nblocks; i++)
+	   ::operator delete(blocks[i]);
+       delete [] blocks;
+       delete [] scopes;
+       slots = NULL;
+       blocks = NULL;
+       scopes = NULL;
+       nslots = nkeys = nblocks = nbindings = scopes_size = depth = 0;
+   }
+
+   void copy_from(const SymbolTable &s)
+   {
+       for (int d = 0; d < s.depth; d++) {
+	   enterscope();
+	   int end = d + 1 < s.depth ? s.scopes[d + 1] : s.nbindings;
+	   for (int n = s.scopes[d]; n < end; n++) {
+	       ScopeEntry &e = s.binding(n)->entry;
+	       addid(e.get_id(), e.get_info());
+	   }
+       }
+   }
+
 public:
-   SymbolTable(): tbl(NULL) { }     // create a new symbol table
+   SymbolTable(): slots(NULL), nslots(0), nkeys(0),
+		  blocks(NULL), nblocks(0), nbindings(0),
+		  scopes(NULL), scopes_size(0), depth(0) { }  // create a new symbol table
+
+   SymbolTable(const SymbolTable &s): slots(NULL), nslots(0), nkeys(0),
+		  blocks(NULL), nblocks(0), nbindings(0),
+		  scopes(NULL), scopes_size(0), depth(0) { copy_from(s); }
 
-   // Create pointer to current symbol table.
-   SymbolTable &operator =(const SymbolTable &s) { tbl = s.tbl; return *this; }
+   ~SymbolTable() { clear(); }
+
+   // Save a copy of the current state of a symbol table.
+   SymbolTable &operator =(const SymbolTable &s)
+   {
+       if (this != &s) {
+	   clear();
+	   copy_from(s);
+       }
+       return *this;
+   }
 
    void fatal_error(char * msg)
    {
      cerr << msg << "\n";
      exit(1);
-   } 
+   }
 
-   // Enter a new scope.  A symbol table is organized as a list of
-   // lists.  The head of the list is the innermost scope, the tail
-   // holds the outer scopes.  A scope must be entered before anything
+   // Enter a new scope.  A scope must be entered before anything
    // can be added to the table.
 
    void enterscope()
    {
-       // The cast of NULL is required for template instantiation to work
-       // correctly.
-       tbl = new ScopeList((Scope *) NULL, tbl);
+       if (depth == scopes_size) {
+	   int *old_scopes = scopes;
+	   scopes_size = scopes_size ? 2 * scopes_size : 16;
+	   scopes = new int[scopes_size];
+	   for (int d = 0; d < depth; d++)
+	       scopes[d] = old_scopes[d];
+	   delete [] old_scopes;
+       }
+       scopes[depth++] = nbindings;
    }
 
-   // Pop the first scope off of the symbol table.
+   // Pop the first scope off of the symbol table, undoing its bindings.
    void exitscope()
    {
        // It is an error to exit a scope that doesn't exist.
-       if (tbl == NULL) {
+       if (depth == 0) {
 	   fatal_error("exitscope: Can't remove scope from an empty symbol table.");
        }
-       tbl = tbl->tl();
+       int start = scopes[--depth];
+       while (nbindings > start) {
+	   Binding *b = binding(--nbindings);
+	   find_slot(b->entry.get_id())->current = b->shadowed;
+	   b->~Binding();
+       }
    }
 
    // Add an item to the symbol table.
    ScopeEntry *addid(SYM s, DAT *i)
    {
        // There must be at least one scope to add a symbol.
-       if (tbl == NULL) fatal_error("addid: Can't add a symbol without a scope.");
-       ScopeEntry * se = new ScopeEntry(s,i);
-       tbl = new ScopeList(new Scope(se, tbl->hd()), tbl->tl());
-       return(se);
+       if (depth == 0) fatal_error("addid: Can't add a symbol without a scope.");
+       Slot *slot = insert_slot(s);
+       Binding *b = new (push_binding()) Binding(s, i, depth, slot->current);
+       slot->current = b;
+       return &b->entry;
    }
-   
+
    // Lookup an item through all scopes of the symbol table.  If found
    // it returns the associated information field, if not it returns
    // NULL.
 
    DAT * lookup(SYM s)
    {
-       for(ScopeList *i = tbl; i != NULL; i=i->tl()) {
-	   for( Scope *j = i->hd(); j != NULL; j = j->tl()) {
-	       if (s == j->hd()->get_id()) {
-		   return (j->hd()->get_info());
-	       }
-	   }
-       }
-       return NULL;
+       if (nslots == 0) return NULL;
+       Binding *b = find_slot(s)->current;
+       return b ? b->entry.get_info() : NULL;
    }
 
    // probe the symbol table.  Check the top scope (only) for the item
    // 's'.  If found, return the information field.  If not return NULL.
    DAT *probe(SYM s)
    {
-       if (tbl == NULL) {
+       if (depth == 0) {
 	   fatal_error("probe: No scope in symbol table.");
        }
-       for(Scope *i = tbl->hd(); i != NULL; i = i->tl()) {
-	   if (s == i->hd()->get_id()) {
-	       return(i->hd()->get_info());
-	   }
-       }
-       return(NULL);
+       if (nslots == 0) return NULL;
+       Binding *b = find_slot(s)->current;
+       return (b && b->scope == depth) ? b->entry.get_info() : NULL;
    }
 
-   // Prints out the contents of the symbol table  
+   // Prints out the contents of the symbol table, innermost scope and
+   // newest binding first.
    void dump()
    {
-      for(ScopeList *i = tbl; i != NULL; i = i->tl()) {
+      int end = nbindings;
+      for (int d = depth - 1; d >= 0; d--) {
          cerr << "\nScope: \n";
-         for(Scope *j = i->hd(); j != NULL; j = j->tl()) {
-            cerr << "  " << j->hd()->get_id() << endl;
+         for (int n = end - 1; n >= scopes[d]; n--) {
+            cerr << "  " << binding(n)->entry.get_id() << endl;
          }
+         end = scopes[d];
       }
    }
- 
+
 };
 
 #endif
-
@@ -0,0 +1,91 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+#ifndef _TOKEN_QUEUE_H_
+#define _TOKEN_QUEUE_H_
+
+#include <sched.h>
+#include "cool-parse.h"
+
+//
+// A TokenQueue passes tokens, with their values and lines, from one
+// thread to one other: from the lexer to the parser, when coolc runs
+// them on two threads (see coolc.cc).  It takes no locks.  Each end
+// moves a counter of its own, and only reads the other's: put fills a
+// slot and then moves tail past it, get empties a slot and then moves
+// head past it, and release and acquire orders on the counters make the
+// slots seen by the other end whole.
+//
+// The ends do not show their counters on every token, but once every
+// TOKEN_QUEUE_BATCH tokens, at the end of the input (token 0), and
+// whenever they have to wait for the other end, so that the counters'
+// cache lines go back and forth less often.  An end that has to wait
+// gives up the processor until the other end has moved.
+//
+#define TOKEN_QUEUE_SIZE   4096	// a power of two
+#define TOKEN_QUEUE_BATCH  64
+
+struct QueuedToken {
+  int token;
+  int lineno;
+  YYSTYPE lval;
+};
+
+class TokenQueue {
+private:
+  QueuedToken slot[TOKEN_QUEUE_SIZE];
+  // The counters the ends show each other, and their own, on cache
+  // lines apart.  The counters run on past TOKEN_QUEUE_SIZE, and wrap.
+  unsigned head __attribute__((aligned(64)));   // shown by get
+  unsigned tail __attribute__((aligned(64)));   // shown by put
+  unsigned put_tail __attribute__((aligned(64)));
+  unsigned put_head;                            // head, as put last saw it
+  unsigned get_head __attribute__((aligned(64)));
+  unsigned get_tail;                            // tail, as get last saw it
+
+public:
+  TokenQueue() : head(0), tail(0), put_tail(0), put_head(0),
+		 get_head(0), get_tail(0) { }
+
+  // called by the producer only
+  void put(int token, int lineno, YYSTYPE *lval)
+  {
+    while (put_tail - put_head == TOKEN_QUEUE_SIZE) {
+      __atomic_store_n(&tail, put_tail, __ATOMIC_RELEASE);
+      put_head = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+      if (put_tail - put_head == TOKEN_QUEUE_SIZE)
+	sched_yield();
+    }
+    QueuedToken &q = slot[put_tail & (TOKEN_QUEUE_SIZE - 1)];
+    q.token = token;
+    q.lineno = lineno;
+    q.lval = *lval;
+    put_tail++;
+    if (token == 0 || put_tail % TOKEN_QUEUE_BATCH == 0)
+      __atomic_store_n(&tail, put_tail, __ATOMIC_RELEASE);
+  }
+
+  // called by the consumer only
+  int get(int *lineno, YYSTYPE *lval)
+  {
+    while (get_head == get_tail) {
+      __atomic_store_n(&head, get_head, __ATOMIC_RELEASE);
+      get_tail = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+      if (get_head == get_tail)
+	sched_yield();
+    }
+    QueuedToken &q = slot[get_head & (TOKEN_QUEUE_SIZE - 1)];
+    int token = q.token;
+    *lineno = q.lineno;
+    *lval = q.lval;
+    get_head++;
+    if (get_head % TOKEN_QUEUE_BATCH == 0)
+      __atomic_store_n(&head, get_head, __ATOMIC_RELEASE);
+    return token;
+  }
+};
+
+#endif
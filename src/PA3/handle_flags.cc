@@ -30,6 +30,12 @@ extern int cool_yydebug;        // for the parser
        bool disable_reg_alloc;  // Don't do register allocation
 
        int cgen_optimize;       // optimize switch for code generator 
+       int binary_ast;          // pass the AST between phases in binary form
+       int binary_tokens;       // lexer: write a binary token stream
+       int pipeline_parse;      // coolc: lex on a thread of its own, ahead of the parser
+       int parallel_parse;      // coolc: lex and parse each file on a thread of its own
+       int scan_threads;        // scan a large file in pieces on this many threads
+       int class_threads;       // coolc: parse the classes of a file on this many threads
        char *out_filename;      // file name for generated code
        Memmgr cgen_Memmgr = GC_NOGC;      // enable/disable garbage collection
        Memmgr_Test cgen_Memmgr_Test = GC_NORMAL;  // normal/test GC
@@ -51,9 +57,15 @@ void handle_flags(int argc, char *argv[]) {
   cgen_debug = 0;
   cgen_optimize = 0;
   disable_reg_alloc = 0;
+  binary_ast = 0;
+  binary_tokens = 0;
+  pipeline_parse = 0;
+  parallel_parse = 0;
+  scan_threads = 0;
+  class_threads = 0;
   
 
-  while ((c = getopt(argc, argv, "lpscvrOo:gtT")) != -1) {
+  while ((c = getopt(argc, argv, "lpscvrOo:gtTbBPjC:J:")) != -1) {
     switch (c) {
 #ifdef DEBUG
     case 'l':
@@ -99,6 +111,25 @@ void handle_flags(int argc, char *argv[]) {
     case 'O':  // enable optimization
       cgen_optimize = 1;
       break;
+    case 'b':  // read and write binary AST files (see compact-ast.h)
+      binary_ast = 1;
+      break;
+    case 'B':  // write a binary token stream (see token-stream.h)
+      binary_tokens = 1;
+      break;
+    case 'P':  // lex and parse on two threads (see coolc.cc)
+      pipeline_parse = 1;
+      break;
+    case 'j':  // lex and parse the files on threads of their own (see coolc.cc)
+      parallel_parse = 1;
+      break;
+    case 'C':  // scan each file in pieces, on this many threads (only the
+               // direct-coded scanner does; see cool-scan.cc)
+      scan_threads = atoi(optarg);
+      break;
+    case 'J':  // parse the classes of each file on this many threads (see coolc.cc)
+      class_threads = atoi(optarg);
+      break;
     case '?':
       unknownopt = 1;
       break;
@@ -111,9 +142,9 @@ void handle_flags(int argc, char *argv[]) {
   if (unknownopt) {
       cerr << "usage: " << argv[0] << 
 #ifdef DEBUG
-	  " [-lvpscOgtTr -o outname] [input-files]\n";
+	  " [-lvpscOgtTrbBPj -C threads -J threads -o outname] [input-files]\n";
 #else
-      " [-OgtT -o outname] [input-files]\n";
+      " [-OgtTbBPj -C threads -J threads -o outname] [input-files]\n";
 #endif
       exit(1);
   }
@@ -0,0 +1,389 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// file: token-stream.cc
+//
+// Writing and reading binary token streams (see token-stream.h).
+//
+// A binary token stream is a TokenStreamHeader followed by blocks of
+// tokens, so that the lexer can write it, and the parser read it, a
+// block at a time through a pipe.  All integers are 32 bits in the byte
+// order of the machine that wrote the stream.  A block is:
+//
+//    a TokenBlockHeader
+//
+//    the entries: first the strings entered into idtable, stringtable
+//    and inttable since the last block (so the tables are built up
+//    block by block, in the order in which the lexer entered them),
+//    table by table, then the texts of this block: its file names and
+//    error messages.  Each entry is its length, its characters and a
+//    terminating NUL, padded with NULs to a multiple of 4 bytes, as in
+//    a binary AST file.
+//
+//    ntokens TokenRecords
+//
+// The value of a TYPEID, OBJECTID, INT_CONST or STR_CONST token is a
+// symbol reference: the table in its top two bits, and the index of the
+// symbol in the entries of that table in the stream so far in the rest
+// (see CompactAst::symbol_ref).  The value of an ERROR token, and of a
+// TOKEN_NAME record (the "#name" line of a textual stream), is the
+// index of its text among the texts of the block.  A BOOL_CONST has its
+// value; any other token has 0.
+//
+// The version is increased whenever the layout changes; a reader
+// rejects any version but its own.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "stringtab.h"
+#include "token-stream.h"
+
+extern __thread int curr_lineno;
+extern __thread char *curr_filename;
+
+#define TOKEN_STREAM_MAGIC   "COOL-TOK"
+#define TOKEN_STREAM_VERSION 1
+
+#define TOKEN_NAME   0      // not a token: the tokens of a new file follow
+#define BLOCK_TOKENS 4096   // the most tokens the writer puts in a block
+
+enum { SYM_ID = 0, SYM_STRING = 1, SYM_INT = 2, TEXTS = 3 };
+
+struct TokenStreamHeader {
+  char magic[8];
+  uint32_t version;
+};
+
+struct TokenBlockHeader {
+  uint32_t nentries[4];     // new entries of each table, and texts
+  uint32_t entry_bytes;     // byte size of the entries
+  uint32_t ntokens;
+};
+
+struct TokenRecord {
+  int32_t token;
+  int32_t line;
+  uint32_t value;
+};
+
+static void bad_token_stream(char *msg)
+{
+  cerr << "binary token stream: " << msg << "\n";
+  exit(1);
+}
+
+static uint32_t entry_bytes(int len)
+{
+  return 4 + (len / 4 + 1) * 4;
+}
+
+//
+// Writing
+//
+// The tokens of a block are kept until it is full (or the stream is
+// flushed), together with the texts they refer to; the strings of the
+// tables are written from where the last block left off.
+//
+static bool header_written = false;
+static TokenRecord records[BLOCK_TOKENS];
+static int nrecords = 0;
+static char *texts[BLOCK_TOKENS];
+static int text_len[BLOCK_TOKENS];
+static int ntexts = 0;
+static int table_written[3] = { 0, 0, 0 };   // entries already written
+
+static void write_entry(ostream &s, char *str, uint32_t len)
+{
+  static const char zeros[4] = { 0, 0, 0, 0 };
+
+  s.write((char *) &len, sizeof(len));
+  s.write(str, len);
+  s.write(zeros, 4 - len % 4);
+}
+
+template <class Elem> static void write_new_entries(ostream &s,
+						     StringTable<Elem> &tbl,
+						     int &written)
+{
+  for (; written < tbl.size(); written++) {
+    Elem *e = tbl.lookup(written);
+    write_entry(s, e->get_string(), e->get_len());
+  }
+}
+
+template <class Elem> static uint32_t new_entry_bytes(StringTable<Elem> &tbl,
+						       int written)
+{
+  uint32_t bytes = 0;
+  for (int i = written; i < tbl.size(); i++)
+    bytes += entry_bytes(tbl.lookup(i)->get_len());
+  return bytes;
+}
+
+void flush_binary_tokens(ostream &s)
+{
+  if (!header_written) {
+    TokenStreamHeader h;
+    memcpy(h.magic, TOKEN_STREAM_MAGIC, sizeof(h.magic));
+    h.version = TOKEN_STREAM_VERSION;
+    s.write((char *) &h, sizeof(h));
+    header_written = true;
+  }
+  if (nrecords == 0)
+    return;
+
+  TokenBlockHeader b;
+  b.nentries[SYM_ID] = idtable.size() - table_written[SYM_ID];
+  b.nentries[SYM_STRING] = stringtable.size() - table_written[SYM_STRING];
+  b.nentries[SYM_INT] = inttable.size() - table_written[SYM_INT];
+  b.nentries[TEXTS] = ntexts;
+  b.entry_bytes = new_entry_bytes(idtable, table_written[SYM_ID]) +
+    new_entry_bytes(stringtable, table_written[SYM_STRING]) +
+    new_entry_bytes(inttable, table_written[SYM_INT]);
+  for (int i = 0; i < ntexts; i++)
+    b.entry_bytes += entry_bytes(text_len[i]);
+  b.ntokens = nrecords;
+
+  s.write((char *) &b, sizeof(b));
+  write_new_entries(s, idtable, table_written[SYM_ID]);
+  write_new_entries(s, stringtable, table_written[SYM_STRING]);
+  write_new_entries(s, inttable, table_written[SYM_INT]);
+  for (int i = 0; i < ntexts; i++)
+    write_entry(s, texts[i], text_len[i]);
+  s.write((char *) records, nrecords * sizeof(TokenRecord));
+  for (int i = 0; i < ntexts; i++)
+    free(texts[i]);
+  nrecords = ntexts = 0;
+}
+
+static void add_record(ostream &s, int token, int line, uint32_t value)
+{
+  TokenRecord &r = records[nrecords++];
+  r.token = token;
+  r.line = line;
+  r.value = value;
+  if (nrecords == BLOCK_TOKENS)
+    flush_binary_tokens(s);
+}
+
+// A text is copied (an error message may point into the lexer's buffer)
+// and referred to by its index in the block.
+static uint32_t add_text(char *str)
+{
+  text_len[ntexts] = strlen(str);
+  texts[ntexts] = strdup(str);
+  return ntexts++;
+}
+
+void write_binary_name(ostream &s, char *name)
+{
+  add_record(s, TOKEN_NAME, 0, add_text(name));
+}
+
+void write_binary_token(ostream &s, int lineno, int token, YYSTYPE yylval)
+{
+  uint32_t value = 0;
+  Span span = yylval.span;
+
+  switch (token) {
+  case TYPEID:
+  case OBJECTID:
+    value = ((uint32_t) SYM_ID << 30) |
+      idtable.add_chars(span.text, span.len)->get_index();
+    break;
+  case STR_CONST:
+    value = ((uint32_t) SYM_STRING << 30) |
+      stringtable.add_chars(span.text, span.len)->get_index();
+    break;
+  case INT_CONST:
+    value = ((uint32_t) SYM_INT << 30) |
+      inttable.add_chars(span.text, span.len)->get_index();
+    break;
+  case BOOL_CONST:
+    value = yylval.boolean;
+    break;
+  case ERROR:
+    value = add_text(yylval.error_msg);
+    break;
+  }
+  add_record(s, token, lineno, value);
+}
+
+//
+// Reading
+//
+// The symbols of the stream so far are kept by index in each table, and
+// a block is read whole.  The entries are entered into the tables as
+// they come, so a token only has to look its symbol up by index.
+//
+static bool header_read = false;
+static Symbol *symbols[3] = { NULL, NULL, NULL };
+static uint32_t nsymbols[3] = { 0, 0, 0 };
+static uint32_t symbols_size[3] = { 0, 0, 0 };
+static char **block_texts = NULL;
+static uint32_t nblock_texts = 0;
+static TokenRecord *block = NULL;
+static uint32_t block_size = 0;
+static uint32_t block_tokens = 0;
+static uint32_t next_token = 0;
+
+static bool read_bytes(FILE *in, void *buf, size_t n, bool eof_ok)
+{
+  size_t got = fread(buf, 1, n, in);
+  if (got == n)
+    return true;
+  if (got == 0 && eof_ok)
+    return false;
+  bad_token_stream("truncated stream");
+  return false;
+}
+
+// read an entry into buf (of room bytes, grown as needed), returning its
+// length; left is what is left of the entries of the block
+static uint32_t read_entry(FILE *in, char *&buf, uint32_t &room, uint32_t &left)
+{
+  uint32_t len;
+  if (left < 8)
+    bad_token_stream("bad entry");
+  read_bytes(in, &len, 4, false);
+  if (len >= left - 4)          // before (len / 4 + 1) * 4 can wrap
+    bad_token_stream("bad entry");
+  uint32_t bytes = (len / 4 + 1) * 4;
+  if (left - 4 < bytes)
+    bad_token_stream("bad entry");
+  if (bytes > room) {
+    delete [] buf;
+    room = 2 * bytes;
+    buf = new char[room];
+  }
+  read_bytes(in, buf, bytes, false);
+  if (buf[len] != '\0')
+    bad_token_stream("bad entry");
+  left -= 4 + bytes;
+  return len;
+}
+
+static bool read_block(FILE *in)
+{
+  static char *buf = NULL;
+  static uint32_t room = 0;
+  TokenBlockHeader b;
+
+  if (!read_bytes(in, &b, sizeof(b), true))
+    return false;
+  uint32_t left = b.entry_bytes;
+
+  for (int t = SYM_ID; t <= SYM_INT; t++) {
+    if (nsymbols[t] + b.nentries[t] > symbols_size[t]) {
+      uint32_t size = 2 * (nsymbols[t] + b.nentries[t]);
+      Symbol *old_symbols = symbols[t];
+      symbols[t] = new Symbol[size];
+      if (old_symbols) {
+	memcpy(symbols[t], old_symbols, nsymbols[t] * sizeof(Symbol));
+	delete [] old_symbols;
+      }
+      symbols_size[t] = size;
+    }
+    for (uint32_t i = 0; i < b.nentries[t]; i++) {
+      uint32_t len = read_entry(in, buf, room, left);
+      Symbol sym;
+      switch (t) {
+      case SYM_ID:     sym = idtable.add_chars(buf, len); break;
+      case SYM_STRING: sym = stringtable.add_chars(buf, len); break;
+      default:         sym = inttable.add_chars(buf, len); break;
+      }
+      symbols[t][nsymbols[t]++] = sym;
+    }
+  }
+
+  // Texts are error messages and file names, which outlive the block.
+  delete [] block_texts;
+  block_texts = new char *[b.nentries[TEXTS]];
+  nblock_texts = b.nentries[TEXTS];
+  for (uint32_t i = 0; i < nblock_texts; i++) {
+    read_entry(in, buf, room, left);
+    block_texts[i] = strdup(buf);
+  }
+  if (left != 0)
+    bad_token_stream("bad entry section size");
+
+  if (b.ntokens > block_size) {
+    delete [] block;
+    block_size = b.ntokens;
+    block = new TokenRecord[block_size];
+  }
+  read_bytes(in, block, b.ntokens * sizeof(TokenRecord), b.ntokens == 0);
+  block_tokens = b.ntokens;
+  next_token = 0;
+  return true;
+}
+
+// A textual stream starts with "#name" or blanks, never with the magic.
+bool is_binary_token_stream(FILE *in)
+{
+  int c = getc(in);
+  ungetc(c, in);
+  return c == TOKEN_STREAM_MAGIC[0];
+}
+
+int read_binary_token(FILE *in)
+{
+  if (!header_read) {
+    TokenStreamHeader h;
+    if (!read_bytes(in, &h, sizeof(h), true))
+      return 0;                 // no tokens at all
+    if (memcmp(h.magic, TOKEN_STREAM_MAGIC, sizeof(h.magic)) != 0)
+      bad_token_stream("not a binary token stream");
+    if (h.version != TOKEN_STREAM_VERSION)
+      bad_token_stream("unsupported version");
+    header_read = true;
+  }
+
+  for (;;) {
+    while (next_token == block_tokens)
+      if (!read_block(in))
+	return 0;
+    TokenRecord &r = block[next_token++];
+    uint32_t t = r.value >> 30;
+    uint32_t i = r.value & ((1 << 30) - 1);
+    Symbol sym;
+
+    switch (r.token) {
+    case TOKEN_NAME:
+    case ERROR:
+      if (r.value >= nblock_texts)
+	bad_token_stream("bad text reference");
+      if (r.token == TOKEN_NAME) {
+	curr_filename = block_texts[r.value];
+	continue;
+      }
+      cool_yylval.error_msg = block_texts[r.value];
+      break;
+    case TYPEID:
+    case OBJECTID:
+    case STR_CONST:
+    case INT_CONST:
+      if (t != (r.token == STR_CONST ? SYM_STRING :
+		r.token == INT_CONST ? SYM_INT : SYM_ID) || i >= nsymbols[t])
+	bad_token_stream("bad symbol reference");
+      sym = symbols[t][i];
+      cool_yylval.span.text = sym->get_string();
+      cool_yylval.span.len = sym->get_len();
+      break;
+    case BOOL_CONST:
+      cool_yylval.boolean = r.value;
+      break;
+    }
+    curr_lineno = r.line;
+    return r.token;
+  }
+}
@@ -0,0 +1,351 @@
+//
+// See copyright.h for copyright notice and limitation of liability
+// and disclaimer of warranty provisions.
+//
+#include "copyright.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  tokens-read.cc
+//
+//  Reads the token stream of the lexer phase, in the form that
+//  dump_cool_token writes it (see utilities.cc):
+//
+//      #name "good.cl"
+//      #12 CLASS
+//      #12 TYPEID Main
+//      #13 '{'
+//      #14 STR_CONST "a\tb\n"
+//
+//  and passes the tokens to the parser through cool_yylex.  A binary
+//  stream (what the lexer writes with -B) is recognized by its first
+//  byte, and is read by read_binary_token instead (see token-stream.h).
+//
+//  This takes the place of tokens-lex.cc, a flex scanner for the same
+//  text, and stops on malformed text with the same messages.  The input
+//  is read a block at a time; a token name is looked up in a perfect
+//  hash table of the names, a string is unescaped as its end is looked
+//  for, and identifiers and constants are entered into their tables as
+//  soon as they are read.  The layout of the text is not checked more
+//  closely than tokens-lex.cc checked it: the parts of a token may be
+//  separated by any whitespace, and tokens need not end lines.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cool-parse.h"
+#include "stringtab.h"
+#include "token-stream.h"
+
+/* Max size of string constants */
+#define MAX_STR_CONST 1025
+
+extern FILE *token_file;	/* we read from this file */
+extern __thread int curr_lineno;
+extern __thread char *curr_filename;
+
+int yy_flex_debug;	/* set by -l; there are no rules to trace here */
+
+#define IS_BLANK(c)	((c) == ' ' || ((c) >= '\b' && (c) <= '\r'))
+#define IS_DIGIT(c)	((c) >= '0' && (c) <= '9')
+#define IS_LETTER(c)	(((c) >= 'a' && (c) <= 'z') || ((c) >= 'A' && (c) <= 'Z'))
+#define IS_IDCHAR(c)	(IS_LETTER(c) || IS_DIGIT(c) || (c) == '_')
+#define IS_NAMECHAR(c)	(((c) >= 'A' && (c) <= 'Z') || (c) == '_')
+#define IS_OCTAL(c)	((c) >= '0' && (c) <= '7')
+
+/*
+ *  The input, a block at a time.  GETC returns the next character, or
+ *  EOF; UNGETC puts back the character that GETC just returned.
+ */
+#define READ_SIZE	65536
+
+static char in_buf[READ_SIZE];
+static char *pos = in_buf;	/* the next character */
+static char *lim = in_buf;	/* the end of what has been read */
+
+static int refill()
+{
+	size_t n = fread(in_buf, 1, READ_SIZE, token_file);
+	pos = in_buf;
+	lim = in_buf + n;
+	return n == 0 ? EOF : (unsigned char) *pos++;
+}
+
+#define GETC()		(pos < lim ? (unsigned char) *pos++ : refill())
+#define UNGETC(c)	((c) == EOF ? (void) 0 : (void) pos--)
+
+/*
+ *  The text of the token being read: a name, identifier or constant as
+ *  it is, or a string unescaped.  It grows as needed.
+ */
+static char *text = NULL;
+static int text_len = 0;
+static int text_size = 0;
+
+static void grow_text()
+{
+	text_size = text_size ? 2 * text_size : 1024;
+	char *t = new char[text_size];
+	memcpy(t, text, text_len);
+	delete [] text;
+	text = t;
+}
+
+#define PUT(c)	do { if (text_len == text_size) grow_text(); \
+		     text[text_len++] = (c); } while (0)
+
+/*
+ *  The parser takes the text of TYPEID, OBJECTID, INT_CONST and STR_CONST
+ *  tokens as spans (see cool.flex).  The text read here does not outlive
+ *  the token, so the span is that of the table entry.
+ */
+static void set_span(Symbol sym)
+{
+	cool_yylval.span.text = sym->get_string();
+	cool_yylval.span.len = sym->get_len();
+}
+
+static void bad_text(const char *what)
+{
+	cerr << "unmatched text in token lexer; " << what << " expected\n";
+	exit(1);
+}
+
+/* the next character that is not whitespace, or EOF */
+static int skip_blanks()
+{
+	int c;
+	do
+		c = GETC();
+	while (IS_BLANK(c));
+	return c;
+}
+
+/*
+ *  The token names, by hash.  name_hash gives each of them a slot of its
+ *  own, from its length and first two characters.
+ */
+#define NAME_SLOTS	64
+#define name_hash(s, len) \
+	((3 * (len) + 7 * (s)[0] + 2 * (s)[1]) & (NAME_SLOTS - 1))
+
+static struct {
+	const char *name;
+	int token;
+} token_names[NAME_SLOTS] = {
+	{ "WHILE", WHILE },        { NULL, 0 },               { "FI", FI },              { NULL, 0 },
+	{ NULL, 0 },               { "OBJECTID", OBJECTID },  { NULL, 0 },               { "ELSE", ELSE },
+	{ "STR_CONST", STR_CONST }, { "NOT", NOT },           { "BOOL_CONST", BOOL_CONST }, { NULL, 0 },
+	{ NULL, 0 },               { NULL, 0 },               { NULL, 0 },               { NULL, 0 },
+	{ "TYPEID", TYPEID },      { "IF", IF },              { NULL, 0 },               { NULL, 0 },
+	{ NULL, 0 },               { "ESAC", ESAC },          { "ERROR", ERROR },        { NULL, 0 },
+	{ NULL, 0 },               { NULL, 0 },               { "POOL", POOL },          { NULL, 0 },
+	{ NULL, 0 },               { NULL, 0 },               { NULL, 0 },               { NULL, 0 },
+	{ NULL, 0 },               { "IN", IN },              { NULL, 0 },               { "CASE", CASE },
+	{ "LE", LE },              { NULL, 0 },               { NULL, 0 },               { "LET", LET },
+	{ "THEN", THEN },          { NULL, 0 },               { NULL, 0 },               { NULL, 0 },
+	{ NULL, 0 },               { NULL, 0 },               { NULL, 0 },               { NULL, 0 },
+	{ "DARROW", DARROW },      { NULL, 0 },               { NULL, 0 },               { "INHERITS", INHERITS },
+	{ NULL, 0 },               { "NEW", NEW },            { "INT_CONST", INT_CONST }, { "ISVOID", ISVOID },
+	{ NULL, 0 },               { NULL, 0 },               { NULL, 0 },               { "OF", OF },
+	{ "CLASS", CLASS },        { NULL, 0 },               { "LOOP", LOOP },          { "ASSIGN", ASSIGN },
+};
+
+/* the token named by the len characters at s, or 0 */
+static int token_code(char *s, int len)
+{
+	if (len < 2)
+		return 0;
+	int slot = name_hash(s, len);
+	const char *name = token_names[slot].name;
+	if (name == NULL || strncmp(name, s, len) != 0 || name[len] != '\0')
+		return 0;
+	return token_names[slot].token;
+}
+
+/*
+ *  A quoted string, after any whitespace, unescaped into text: \n, \t,
+ *  \b, \f, \\, \" and three octal digits are escapes, and a backslash
+ *  before anything else is itself.  A newline in the quotes is dropped.
+ *  Returns the length of the string up to its first null character (the
+ *  rest is not used), and text ends in a null; at EOF, returns -1.
+ */
+static int quoted(const char *what)
+{
+	int c = skip_blanks(), d, e, nul = -1;
+
+	if (c == EOF)
+		return -1;
+	if (c != '"')
+		bad_text(what);
+	text_len = 0;
+	for (;;) {
+		switch (c = GETC()) {
+		case EOF:
+			return -1;
+		case '"':
+			PUT('\0');
+			return nul < 0 ? text_len - 1 : nul;
+		case '\n':
+			continue;
+		case '\\':
+			switch (c = GETC()) {
+			case 'n':  c = '\n'; break;
+			case 't':  c = '\t'; break;
+			case 'b':  c = '\b'; break;
+			case 'f':  c = '\f'; break;
+			case '\\': case '"': break;
+			case '0': case '1': case '2': case '3':
+			case '4': case '5': case '6': case '7':
+				d = GETC();
+				if (!IS_OCTAL(d)) {	/* the digit is itself */
+					PUT('\\');
+					PUT(c);
+					UNGETC(d);
+					continue;
+				}
+				e = GETC();
+				if (!IS_OCTAL(e)) {
+					PUT('\\');
+					PUT(c);
+					PUT(d);
+					UNGETC(e);
+					continue;
+				}
+				c = ((c - '0') << 6) | ((d - '0') << 3) | (e - '0');
+				break;
+			default:
+				PUT('\\');
+				UNGETC(c);
+				continue;
+			}
+			break;
+		}
+		if ((char) c == '\0' && nul < 0)
+			nul = text_len;
+		PUT(c);
+	}
+}
+
+/*
+ *  Reads a token, sets its line and value, and returns it, or 0 at the
+ *  end of the stream.  "#name" lines are read on the way.
+ */
+static int read_token()
+{
+	int c, len, token;
+	unsigned line;
+
+	for (;;) {
+		if ((c = skip_blanks()) == EOF)
+			return 0;
+		if (c != '#')
+			bad_text("line number");
+		c = GETC();
+		if (IS_DIGIT(c))
+			break;
+		if (c != 'n' || GETC() != 'a' || GETC() != 'm' || GETC() != 'e')
+			bad_text("line number");
+		if (quoted("line number") < 0)
+			return 0;
+		curr_filename = strdup(text);
+	}
+
+	line = 0;
+	do {
+		line = 10 * line + (c - '0');
+		c = GETC();
+	} while (IS_DIGIT(c));
+	curr_lineno = line;
+
+	if (IS_BLANK(c))
+		c = skip_blanks();
+	if (c == EOF)
+		return 0;
+	if (c == '\'') {
+		c = GETC();
+		switch (c) {
+		case '(': case ')': case '*': case '+': case ',': case '-':
+		case '.': case '/': case ':': case ';': case '<': case '=':
+		case '@': case '{': case '}': case '~':
+			if (GETC() == '\'')
+				return c;
+		}
+		bad_text("token");
+	}
+	text_len = 0;
+	while (IS_NAMECHAR(c)) {
+		PUT(c);
+		c = GETC();
+	}
+	UNGETC(c);
+	if (!(token = token_code(text, text_len)))
+		bad_text("token");
+
+	switch (token) {
+	case STR_CONST:
+		if ((len = quoted("string constant")) < 0)
+			return 0;
+		set_span(stringtable.add_chars(text, len < MAX_STR_CONST ?
+						     len : MAX_STR_CONST));
+		break;
+	case ERROR:
+		if (quoted("error message") < 0)
+			return 0;
+		cool_yylval.error_msg = strdup(text);
+		break;
+	case INT_CONST:
+		if ((c = skip_blanks()) == EOF)
+			return 0;
+		if (!IS_DIGIT(c))
+			bad_text("int constant");
+		text_len = 0;
+		do {
+			PUT(c);
+			c = GETC();
+		} while (IS_DIGIT(c));
+		UNGETC(c);
+		set_span(inttable.add_chars(text, text_len));
+		break;
+	case BOOL_CONST: {
+		if ((c = skip_blanks()) == EOF)
+			return 0;
+		const char *rest = c == 't' ? "rue" : c == 'f' ? "alse" : NULL;
+		if (rest == NULL)
+			bad_text("bool constant");
+		for (; *rest; rest++)
+			if (GETC() != *rest)
+				bad_text("bool constant");
+		cool_yylval.boolean = c == 't';
+		break;
+	}
+	case TYPEID:
+	case OBJECTID:
+		if ((c = skip_blanks()) == EOF)
+			return 0;
+		if (!IS_LETTER(c))
+			bad_text(token == TYPEID ? "type symbol" : "object symbol");
+		text_len = 0;
+		do {
+			PUT(c);
+			c = GETC();
+		} while (IS_IDCHAR(c));
+		UNGETC(c);
+		set_span(idtable.add_chars(text, text_len));
+		break;
+	}
+	return token;
+}
+
+static int binary_stream = -1;	/* not known until the first token */
+
+int cool_yylex()
+{
+	if (binary_stream < 0)
+		binary_stream = is_binary_token_stream(token_file);
+	if (binary_stream)
+		return read_binary_token(token_file);
+	return read_token();
+}
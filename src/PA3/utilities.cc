@@ -25,8 +25,6 @@
 #include "stringtab.h"   // Symbol <-> String conversions
 #include "utilities.h"
 
-// #define CHECK_TABLES
-
 // sm: fixed an off-by-one error here; code assumed there were 80 spaces, but
 // in fact only 79 spaces were there; I've made it 80 now
 //                                1         2         3         4         5         6         7
@@ -42,7 +40,13 @@ void fatal_error(char *msg)
 
 void print_escaped_string(ostream& str, const char *s)
 {
-  while (*s) {
+  print_escaped_string(str, s, strlen(s));
+}
+
+// print the first len characters of s, which may contain nulls
+void print_escaped_string(ostream& str, const char *s, int len)
+{
+  for (const char *end = s + len; s < end; s++) {
     switch (*s) {
     case '\\' : str << "\\\\"; break;
     case '\"' : str << "\\\""; break;
@@ -66,10 +70,18 @@ void print_escaped_string(ostream& str, const char *s)
 	    << dec << setfill(' ');
       break;
     }
-    s++;
   }
 }
 
+//
+// The text of TYPEID, OBJECTID, INT_CONST and STR_CONST tokens comes from
+// the lexer as a span of its input (see cool.flex); it is not interned.
+//
+static void print_span(ostream& str, Span s)
+{
+  str.write(s.text, s.len);
+}
+
 //
 // The following two functions are used for debugging the parser.
 //
@@ -123,40 +135,33 @@ char *cool_token_to_string(int tok)
   }
 }
 
-void print_cool_token(int tok)
+void print_cool_token(ostream& out, int tok)
 {
 
-  cerr << cool_token_to_string(tok);
+  out << cool_token_to_string(tok);
 
   switch (tok) {
   case (STR_CONST):
-    cerr << " = ";
-    cerr << " \"";
-    print_escaped_string(cerr, cool_yylval.symbol->get_string());
-    cerr << "\"";
-#ifdef CHECK_TABLES
-    stringtable.lookup_string(cool_yylval.symbol->get_string());
-#endif
+    out << " = ";
+    out << " \"";
+    print_escaped_string(out, cool_yylval.span.text, cool_yylval.span.len);
+    out << "\"";
     break;
   case (INT_CONST):
-    cerr << " = " << cool_yylval.symbol;
-#ifdef CHECK_TABLES
-    inttable.lookup_string(cool_yylval.symbol->get_string());
-#endif
+    out << " = ";
+    print_span(out, cool_yylval.span);
     break;
   case (BOOL_CONST):
-    cerr << (cool_yylval.boolean ? " = true" : " = false");
+    out << (cool_yylval.boolean ? " = true" : " = false");
     break;
   case (TYPEID):
   case (OBJECTID):
-    cerr << " = " << cool_yylval.symbol;
-#ifdef CHECK_TABLES
-    idtable.lookup_string(cool_yylval.symbol->get_string());
-#endif
+    out << " = ";
+    print_span(out, cool_yylval.span);
     break;
   case (ERROR): 
-    cerr << " = ";
-    print_escaped_string(cerr, cool_yylval.error_msg);
+    out << " = ";
+    print_escaped_string(out, cool_yylval.error_msg);
     break;
   }
 }
@@ -169,27 +174,20 @@ void dump_cool_token(ostream& out, int lineno, int token, YYSTYPE yylval)
     switch (token) {
     case (STR_CONST):
 	out << " \"";
-	print_escaped_string(out, cool_yylval.symbol->get_string());
+	print_escaped_string(out, cool_yylval.span.text, cool_yylval.span.len);
 	out << "\"";
-#ifdef CHECK_TABLES
-	stringtable.lookup_string(cool_yylval.symbol->get_string());
-#endif
 	break;
     case (INT_CONST):
-	out << " " << cool_yylval.symbol;
-#ifdef CHECK_TABLES
-	inttable.lookup_string(cool_yylval.symbol->get_string());
-#endif
+	out << " ";
+	print_span(out, cool_yylval.span);
 	break;
     case (BOOL_CONST):
 	out << (cool_yylval.boolean ? " true" : " false");
 	break;
     case (TYPEID):
     case (OBJECTID):
-	out << " " << cool_yylval.symbol;
-#ifdef CHECK_TABLES
-	idtable.lookup_string(cool_yylval.symbol->get_string());
-#endif
+	out << " ";
+	print_span(out, cool_yylval.span);
 	break;
     case (ERROR): 
         // sm: I've changed assignment 2 so students are supposed to
@@ -3,15 +3,20 @@
 #include <string.h>
 #include "cool-io.h"  //includes iostream
 #include "cool-tree.h"
+#include "compact-ast.h"
+#include "cool-parse.h"
 #include "cgen_gc.h"
 
 extern int optind;            // for option processing
 extern char *out_filename;    // name of output assembly
-extern Program ast_root;             // root of the abstract syntax tree
+Program ast_root;             // root of the abstract syntax tree
 FILE *ast_file = stdin;       // we read the AST from standard input
-extern int ast_yyparse(void); // entry point to the AST parser
+extern Program read_text_ast(FILE *f); // the AST reader (ast-read.cc)
+extern int binary_ast;        // read the AST in binary form
 
 int cool_yydebug;     // not used, but needed to link with handle_flags
+int yy_flex_debug;    // likewise
+__thread YYSTYPE cool_yylval;  // not used, but needed to link with utilities
 char *curr_filename;
 
 void handle_flags(int argc, char *argv[]);
@@ -34,7 +39,10 @@ int main(int argc, char *argv[]) {
   // Don't touch the output file until we know that earlier phases of the
   // compiler have succeeded.
   //
-  ast_yyparse();
+  if (binary_ast)
+      ast_root = read_binary_ast(fileno(ast_file));
+  else
+      ast_root = read_text_ast(ast_file);
 
   if (out_filename) {
       ofstream s(out_filename);
@@ -46,5 +54,6 @@ int main(int argc, char *argv[]) {
   } else {
       ast_root->cgen(cout);
   }
+  release_tree_nodes();
 }
 
@@ -19,7 +19,7 @@ void dump_Boolean(ostream& stream, int padding, Boolean b);
 //
 //  dumptype.cc
 //
-//  dumptype defines a simple recursive traversal of the abstract
+//  dumptype defines a simple traversal of the abstract
 //  syntax tree (AST) that prints each node and any associated
 //  type information.  Use dump_with_types to inspect the results of
 //  type inference.
@@ -31,11 +31,13 @@ void dump_Boolean(ostream& stream, int padding, Boolean b);
 //   
 //  dump_with_types is just a simple pretty printer, formatting the output
 //  to show the AST relationships between nodes and their types.
-//  dump_type is a virtual function, with a separate implementation for
+//  Its hooks are virtual functions, with a separate implementation for
 //  each kind of AST node.  Using virtual functions is an easy way to
-//  implement recursive tree traversals in C++; each kind of tree node
-//  has a virtual function that "knows" how to perform the part of
-//  the traversal for that one node.  It may help to know the inheritance hierarchy
+//  implement tree traversals in C++; each kind of tree node
+//  has virtual functions that "know" how to perform the part of
+//  the traversal for that one node, and the walk (a tree_walker, see
+//  tree.h) takes it from node to node without recursion.
+//  It may help to know the inheritance hierarchy
 //  of the classes that define the structure of the Cool AST.  In the 
 //  list below, the outer classes are the Phyla which group together
 //  related kinds of abstract tree nodes (e.g., the two kinds of Features
@@ -123,30 +125,51 @@ void dump_line(ostream& stream, int n, tree_node *t)
   stream << pad(n) << "#" << t->get_line_number() << "\n";
 }
 
+//
+//  dump_with_types walks the tree with a tree_walker (see tree.h), which
+//  calls the dump_with_types hooks of each node: dump_with_types_pre
+//  prints what comes before the node's subtrees and returns their
+//  indentation, dump_with_types_in what comes between them, and
+//  dump_with_types_post what comes after them.  A list prints nothing
+//  of its own: its elements are printed at the indentation of the list.
+//
+class dump_types_walker : public tree_walker {
+   ostream& stream;
+public:
+   dump_types_walker(ostream& s) : stream(s) { }
+   int pre(tree_node *t, int n)
+      { return t->dump_with_types_pre(stream, n); }
+   void in(tree_node *t, int n, int i)
+      { t->dump_with_types_in(stream, n, i); }
+   void post(tree_node *t, int n)
+      { t->dump_with_types_post(stream, n); }
+};
+
+void tree_node::dump_with_types(ostream& stream, int n)
+{
+   dump_types_walker w(stream);
+   w.walk(this, n);
+}
+
 //
 //  program_class prints "program" and then each of the
 //  component classes of the program, one at a time, at a
-//  greater indentation. The recursive invocation on
-//  "classes->nth(i)->dump_with_types(...)" shows how useful
-//  and compact virtual functions are for this kind of computation.
+//  greater indentation.  The classes are printed by the walk, through
+//  their own hooks; this shows how useful virtual functions are for
+//  this kind of computation.
 //
-//  Note the use of the iterator to cycle through all of the
-//  classes.  The methods first, more, next, and nth on AST lists
-//  are defined in tree.h.
-//
-void program_class::dump_with_types(ostream& stream, int n)
+int program_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_program\n";
-   for(int i = classes->first(); classes->more(i); i = classes->next(i))
-     classes->nth(i)->dump_with_types(stream, n+2);
+   return n+2;
 }
 
 //
-// Prints the components of a class, including all of the features.
-// Note that printing the Features is another use of an iterator.
+// Prints the components of a class, including all of the features
+// (in parentheses, which the post hook closes).
 //
-void class__class::dump_with_types(ostream& stream, int n)
+int class__class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_class\n";
@@ -155,158 +178,185 @@ void class__class::dump_with_types(ostream& stream, int n)
    stream << pad(n+2) << "\"";
    print_escaped_string(stream, filename->get_string());
    stream << "\"\n" << pad(n+2) << "(\n";
-   for(int i = features->first(); features->more(i); i = features->next(i))
-     features->nth(i)->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void class__class::dump_with_types_post(ostream& stream, int n)
+{
    stream << pad(n+2) << ")\n";
 }
 
 
 //
 // dump_with_types for method_class first prints that this is a method,
-// then prints the method name followed by the formal parameters
-// (another use of an iterator, this time access all of the list members
-// of type Formal), the return type, and finally calls dump_type recursively
-// on the method body. 
+// then the method name; the walk prints the formal parameters, the in
+// hook the return type (between the formals and the body), and the
+// walk the method body.
 
-void method_class::dump_with_types(ostream& stream, int n)
+int method_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_method\n";
    dump_Symbol(stream, n+2, name);
-   for(int i = formals->first(); formals->more(i); i = formals->next(i))
-     formals->nth(i)->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void method_class::dump_with_types_in(ostream& stream, int n, int i)
+{
    dump_Symbol(stream, n+2, return_type);
-   expr->dump_with_types(stream, n+2);
 }
 
 //
-//  attr_class::dump_with_types prints the attribute name, type declaration,
-//  and any initialization expression at the appropriate offset.
+//  attr_class::dump_with_types_pre prints the attribute name and type
+//  declaration; the initialization expression follows at the same
+//  offset.
 //
-void attr_class::dump_with_types(ostream& stream, int n)
+int attr_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_attr\n";
    dump_Symbol(stream, n+2, name);
    dump_Symbol(stream, n+2, type_decl);
-   init->dump_with_types(stream, n+2);
+   return n+2;
 }
 
 //
-// formal_class::dump_with_types dumps the name and type declaration
+// formal_class::dump_with_types_pre dumps the name and type declaration
 // of a formal parameter.
 //
-void formal_class::dump_with_types(ostream& stream, int n)
+int formal_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_formal\n";
    dump_Symbol(stream, n+2, name);
    dump_Symbol(stream, n+2, type_decl);
+   return n+2;
 }
 
 //
-// branch_class::dump_with_types dumps the name, type declaration,
-// and body of any case branch.
+// branch_class::dump_with_types_pre dumps the name and type declaration
+// of any case branch; its body follows.
 //
-void branch_class::dump_with_types(ostream& stream, int n)
+int branch_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_branch\n";
    dump_Symbol(stream, n+2, name);
    dump_Symbol(stream, n+2, type_decl);
-   expr->dump_with_types(stream, n+2);
+   return n+2;
 }
 
 //
-// assign_class::dump_with_types prints "assign" and then (indented)
-// the variable being assigned, the expression, and finally the type
-// of the result.  Note the call to dump_type (see above) at the
-// end of the method.
+// assign_class prints "assign" and then (indented) the variable being
+// assigned, the expression, and finally the type of the result.  Note
+// the call to dump_type (see above) in the post hook: every expression
+// ends with its type.
 //
-void assign_class::dump_with_types(ostream& stream, int n)
+int assign_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_assign\n";
    dump_Symbol(stream, n+2, name);
-   expr->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void assign_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
 //
-// static_dispatch_class::dump_with_types prints the expression,
-// static dispatch class, function name, and actual arguments
-// of any static dispatch.  
+// static_dispatch_class prints the expression, static dispatch class,
+// function name, and actual arguments (in parentheses) of any static
+// dispatch.
 //
-void static_dispatch_class::dump_with_types(ostream& stream, int n)
+int static_dispatch_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_static_dispatch\n";
-   expr->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void static_dispatch_class::dump_with_types_in(ostream& stream, int n, int i)
+{
    dump_Symbol(stream, n+2, type_name);
    dump_Symbol(stream, n+2, name);
    stream << pad(n+2) << "(\n";
-   for(int i = actual->first(); actual->more(i); i = actual->next(i))
-     actual->nth(i)->dump_with_types(stream, n+2);
+}
+
+void static_dispatch_class::dump_with_types_post(ostream& stream, int n)
+{
    stream << pad(n+2) << ")\n";
    dump_type(stream,n);
 }
 
 //
-//   dispatch_class::dump_with_types is similar to 
-//   static_dispatch_class::dump_with_types 
+//   dispatch_class is similar to static_dispatch_class
 //
-void dispatch_class::dump_with_types(ostream& stream, int n)
+int dispatch_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_dispatch\n";
-   expr->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void dispatch_class::dump_with_types_in(ostream& stream, int n, int i)
+{
    dump_Symbol(stream, n+2, name);
    stream << pad(n+2) << "(\n";
-   for(int i = actual->first(); actual->more(i); i = actual->next(i))
-     actual->nth(i)->dump_with_types(stream, n+2);
+}
+
+void dispatch_class::dump_with_types_post(ostream& stream, int n)
+{
    stream << pad(n+2) << ")\n";
    dump_type(stream,n);
 }
 
 //
-// cond_class::dump_with_types dumps each of the three expressions
-// in the conditional and then the type of the entire expression.
+// cond_class dumps each of the three expressions in the conditional
+// and then the type of the entire expression.
 //
-void cond_class::dump_with_types(ostream& stream, int n)
+int cond_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_cond\n";
-   pred->dump_with_types(stream, n+2);
-   then_exp->dump_with_types(stream, n+2);
-   else_exp->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void cond_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
 //
-// loop_class::dump_with_types dumps the predicate and then the
-// body of the loop, and finally the type of the entire expression.
+// loop_class dumps the predicate and then the body of the loop, and
+// finally the type of the entire expression.
 //
-void loop_class::dump_with_types(ostream& stream, int n)
+int loop_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_loop\n";
-   pred->dump_with_types(stream, n+2);
-   body->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void loop_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
 //
-//  typcase_class::dump_with_types dumps each branch of the
-//  the Case_ one at a time.  The type of the entire expression
-//  is dumped at the end.
+//  typcase_class dumps each branch of the the Case_ one at a time.
+//  The type of the entire expression is dumped at the end.
 //
-void typcase_class::dump_with_types(ostream& stream, int n)
+int typcase_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_typcase\n";
-   expr->dump_with_types(stream, n+2);
-   for(int i = cases->first(); cases->more(i); i = cases->next(i))
-     cases->nth(i)->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void typcase_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
@@ -315,160 +365,227 @@ void typcase_class::dump_with_types(ostream& stream, int n)
 //  and introduce nothing that isn't already in the code discussed
 //  above.
 //
-void block_class::dump_with_types(ostream& stream, int n)
+int block_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_block\n";
-   for(int i = body->first(); body->more(i); i = body->next(i))
-     body->nth(i)->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void block_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void let_class::dump_with_types(ostream& stream, int n)
+int let_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_let\n";
    dump_Symbol(stream, n+2, identifier);
    dump_Symbol(stream, n+2, type_decl);
-   init->dump_with_types(stream, n+2);
-   body->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void let_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void plus_class::dump_with_types(ostream& stream, int n)
+int plus_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_plus\n";
-   e1->dump_with_types(stream, n+2);
-   e2->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void plus_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void sub_class::dump_with_types(ostream& stream, int n)
+int sub_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_sub\n";
-   e1->dump_with_types(stream, n+2);
-   e2->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void sub_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void mul_class::dump_with_types(ostream& stream, int n)
+int mul_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_mul\n";
-   e1->dump_with_types(stream, n+2);
-   e2->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void mul_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void divide_class::dump_with_types(ostream& stream, int n)
+int divide_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_divide\n";
-   e1->dump_with_types(stream, n+2);
-   e2->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void divide_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void neg_class::dump_with_types(ostream& stream, int n)
+int neg_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_neg\n";
-   e1->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void neg_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void lt_class::dump_with_types(ostream& stream, int n)
+int lt_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_lt\n";
-   e1->dump_with_types(stream, n+2);
-   e2->dump_with_types(stream, n+2);
-   dump_type(stream,n);
+   return n+2;
 }
 
+void lt_class::dump_with_types_post(ostream& stream, int n)
+{
+   dump_type(stream,n);
+}
 
-void eq_class::dump_with_types(ostream& stream, int n)
+int eq_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_eq\n";
-   e1->dump_with_types(stream, n+2);
-   e2->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void eq_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void leq_class::dump_with_types(ostream& stream, int n)
+int leq_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_leq\n";
-   e1->dump_with_types(stream, n+2);
-   e2->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void leq_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void comp_class::dump_with_types(ostream& stream, int n)
+int comp_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_comp\n";
-   e1->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void comp_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void int_const_class::dump_with_types(ostream& stream, int n)
+int int_const_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_int\n";
    dump_Symbol(stream, n+2, token);
+   return n+2;
+}
+
+void int_const_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void bool_const_class::dump_with_types(ostream& stream, int n)
+int bool_const_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_bool\n";
    dump_Boolean(stream, n+2, val);
+   return n+2;
+}
+
+void bool_const_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void string_const_class::dump_with_types(ostream& stream, int n)
+int string_const_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_string\n";
    stream << pad(n+2) << "\"";
    print_escaped_string(stream,token->get_string());
    stream << "\"\n";
+   return n+2;
+}
+
+void string_const_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void new__class::dump_with_types(ostream& stream, int n)
+int new__class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_new\n";
    dump_Symbol(stream, n+2, type_name);
+   return n+2;
+}
+
+void new__class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void isvoid_class::dump_with_types(ostream& stream, int n)
+int isvoid_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_isvoid\n";
-   e1->dump_with_types(stream, n+2);
+   return n+2;
+}
+
+void isvoid_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void no_expr_class::dump_with_types(ostream& stream, int n)
+int no_expr_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_no_expr\n";
+   return n+2;
+}
+
+void no_expr_class::dump_with_types_post(ostream& stream, int n)
+{
    dump_type(stream,n);
 }
 
-void object_class::dump_with_types(ostream& stream, int n)
+int object_class::dump_with_types_pre(ostream& stream, int n)
 {
    dump_line(stream,n,this);
    stream << pad(n) << "_object\n";
    dump_Symbol(stream, n+2, name);
-   dump_type(stream,n);
+   return n+2;
 }
 
+void object_class::dump_with_types_post(ostream& stream, int n)
+{
+   dump_type(stream,n);
+}